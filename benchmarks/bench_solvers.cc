@@ -0,0 +1,286 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "ant/ant.h"
+#include "common/benchmark.h"
+#include "common/random.h"
+#include "gauss/gauss.h"
+#include "grape/grape.h"
+
+// Usage: bench_solvers [--json=FILE] [--filter=SUBSTRING] [--min-time=SEC]
+//                      [--perf] [--affinity=compact|scatter]
+// --perf adds per-phase, per-thread hardware counters to the JSON;
+// --affinity pins the workers of every pool.
+
+namespace {
+
+using s21::Benchmark;
+using s21::Matrix;
+
+const std::size_t kMatrixSizes[] = {128, 256, 512};
+const std::size_t kLargeMatrixSizes[] = {1024, 2048, 4096};
+const std::size_t kCitySizes[] = {50, 100, 200};
+const std::size_t kLargeCitySizes[] = {1000, 2000};
+constexpr std::uint64_t kSeed = 21;
+
+s21::ThreadPool::Placement placement;
+
+std::vector<std::size_t> ThreadSweep() {
+  std::size_t max_threads =
+      std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  std::vector<std::size_t> sweep;
+  for (std::size_t threads = 1; threads < max_threads; threads *= 2) {
+    sweep.push_back(threads);
+  }
+  sweep.push_back(max_threads);
+  return sweep;
+}
+
+Matrix<double> RandomMatrix(std::size_t rows, std::size_t cols,
+                            s21::Xoshiro256& generator) {
+  Matrix<double> matrix(rows, cols);
+  for (std::size_t i = 0; i < rows; ++i) {
+    for (std::size_t j = 0; j < cols; ++j) {
+      matrix(i, j) = generator.NextDouble() * 2.0 - 1.0;
+    }
+  }
+  return matrix;
+}
+
+void BenchGauss(Benchmark& benchmark) {
+  s21::Xoshiro256 generator(kSeed);
+  for (std::size_t n : kMatrixSizes) {
+    Matrix<double> A = RandomMatrix(n, n, generator);
+    std::vector<double> B(n);
+    for (double& b : B) {
+      b = generator.NextDouble();
+    }
+    double n3 = double(n) * double(n) * double(n);
+    double gflop = (2.0 / 3.0 * n3 + 2.0 * double(n) * double(n)) / 1e9;
+    Benchmark::Parameters size{{"n", double(n)}};
+
+    // Solve() works on its copy of the system, so every call reloads it.
+    s21::Gauss gauss;
+    benchmark.Run("Gauss", size, gflop, "GFLOP/s", [&] {
+      gauss.LoadData(A, B);
+      return gauss.Solve();
+    });
+    s21::BlockedGauss blocked_gauss;
+    benchmark.Run("BlockedGauss", size, gflop, "GFLOP/s", [&] {
+      blocked_gauss.LoadData(A, B);
+      return blocked_gauss.Solve();
+    });
+    for (std::size_t threads : ThreadSweep()) {
+      s21::ThreadPool pool(threads, placement);
+      Benchmark::Parameters parameters{{"n", double(n)},
+                                       {"threads", double(threads)}};
+      s21::ParallelGauss parallel_gauss;
+      benchmark.Run("ParallelGauss", parameters, gflop, "GFLOP/s", [&] {
+        parallel_gauss.LoadData(A, B);
+        return parallel_gauss.Solve(pool);
+      });
+    }
+  }
+}
+
+// The sizes BlockedGauss is meant to beat Gauss at, with ParallelGauss on
+// the widest pool only.
+void BenchLargeGauss(Benchmark& benchmark) {
+  s21::Xoshiro256 generator(kSeed);
+  std::size_t threads = ThreadSweep().back();
+  s21::ThreadPool pool(threads, placement);
+  for (std::size_t n : kLargeMatrixSizes) {
+    Matrix<double> A = RandomMatrix(n, n, generator);
+    std::vector<double> B(n);
+    for (double& b : B) {
+      b = generator.NextDouble();
+    }
+    double n3 = double(n) * double(n) * double(n);
+    double gflop = (2.0 / 3.0 * n3 + 2.0 * double(n) * double(n)) / 1e9;
+    Benchmark::Parameters size{{"n", double(n)}};
+
+    s21::Gauss gauss;
+    benchmark.Run("Gauss", size, gflop, "GFLOP/s", [&] {
+      gauss.LoadData(A, B);
+      return gauss.Solve();
+    });
+    s21::BlockedGauss blocked_gauss;
+    benchmark.Run("BlockedGauss", size, gflop, "GFLOP/s", [&] {
+      blocked_gauss.LoadData(A, B);
+      return blocked_gauss.Solve();
+    });
+    s21::ParallelGauss parallel_gauss;
+    benchmark.Run("ParallelGauss",
+                  {{"n", double(n)}, {"threads", double(threads)}}, gflop,
+                  "GFLOP/s", [&] {
+                    parallel_gauss.LoadData(A, B);
+                    return parallel_gauss.Solve(pool);
+                  });
+  }
+}
+
+void BenchGrape(Benchmark& benchmark) {
+  s21::Xoshiro256 generator(kSeed);
+  for (std::size_t n : kMatrixSizes) {
+    Matrix<double> m1 = RandomMatrix(n, n, generator);
+    Matrix<double> m2 = RandomMatrix(n, n, generator);
+    double gflop = 2.0 * double(n) * double(n) * double(n) / 1e9;
+
+    s21::Grape grape(m1, m2);
+    benchmark.Run("Grape", {{"n", double(n)}}, gflop, "GFLOP/s",
+                  [&] { return grape.Mul(); });
+    for (std::size_t threads : ThreadSweep()) {
+      s21::ThreadPool pool(threads, placement);
+      Benchmark::Parameters parameters{{"n", double(n)},
+                                       {"threads", double(threads)}};
+      s21::ClassicParallelGrape classic(m1, m2);
+      benchmark.Run("ClassicParallelGrape", parameters, gflop, "GFLOP/s",
+                    [&] { return classic.Mul(pool); });
+      s21::PipelineParallelGrape pipeline(m1, m2);
+      benchmark.Run("PipelineParallelGrape", parameters, gflop, "GFLOP/s",
+                    [&] { return pipeline.Mul(pool); });
+    }
+  }
+}
+
+// The sizes the blocked Winograd kernel is meant for, on the widest pool
+// only: PipelineParallelGrape and the thread sweep would take minutes there.
+void BenchLargeGrape(Benchmark& benchmark) {
+  s21::Xoshiro256 generator(kSeed);
+  std::size_t threads = ThreadSweep().back();
+  s21::ThreadPool pool(threads, placement);
+  for (std::size_t n : kLargeMatrixSizes) {
+    Matrix<double> m1 = RandomMatrix(n, n, generator);
+    Matrix<double> m2 = RandomMatrix(n, n, generator);
+    double gflop = 2.0 * double(n) * double(n) * double(n) / 1e9;
+
+    s21::Grape grape(m1, m2);
+    benchmark.Run("Grape", {{"n", double(n)}}, gflop, "GFLOP/s",
+                  [&] { return grape.Mul(); });
+    s21::ClassicParallelGrape classic(m1, m2);
+    benchmark.Run("ClassicParallelGrape",
+                  {{"n", double(n)}, {"threads", double(threads)}}, gflop,
+                  "GFLOP/s", [&] { return classic.Mul(pool); });
+  }
+}
+
+// Random EUC_2D instances, written out once so that the graph loads through
+// the usual TSPLIB path.
+void LoadRandomGraph(s21::Graph& graph, std::size_t n,
+                     s21::Xoshiro256& generator) {
+  auto filename =
+      (std::filesystem::temp_directory_path() / "bench_solvers.tsp").string();
+  {
+    std::ofstream file(filename);
+    file << "DIMENSION: " << n << "\nEDGE_WEIGHT_TYPE: EUC_2D\n"
+         << "NODE_COORD_SECTION\n";
+    for (std::size_t i = 1; i <= n; ++i) {
+      file << i << ' ' << generator.NextDouble() * 1000.0 << ' '
+           << generator.NextDouble() * 1000.0 << '\n';
+    }
+  }
+  graph.LoadTsplibFromFile(filename);
+  std::filesystem::remove(filename);
+}
+
+void BenchAnt(Benchmark& benchmark) {
+  s21::Xoshiro256 generator(kSeed);
+  for (std::size_t n : kCitySizes) {
+    s21::Graph graph;
+    LoadRandomGraph(graph, n, generator);
+
+    s21::Ant ant;
+    ant.LoadGraph(graph);
+    s21::Ant::Options options;
+    options.number_of_ants = n;
+    options.max_iterations = 20;
+    options.seed = kSeed;
+    ant.SetOptions(options);
+    double tours = double(options.number_of_ants * options.max_iterations);
+
+    benchmark.Run("Ant", {{"n", double(n)}}, tours, "tours/s",
+                  [&] { return ant.Solve(); });
+    for (std::size_t threads : ThreadSweep()) {
+      s21::ThreadPool pool(threads, placement);
+      Benchmark::Parameters parameters{{"n", double(n)},
+                                       {"threads", double(threads)}};
+      benchmark.Run("ParallelAnt", parameters, tours, "tours/s",
+                    [&] { return ant.Solve(pool); });
+    }
+  }
+}
+
+// Few ants on larger instances, where building the tours dominates: every
+// step runs the selection kernel over a whole row of choice values, or only
+// over the candidates ("ant/construct_tour" under --perf).
+void BenchAntConstruction(Benchmark& benchmark) {
+  s21::Xoshiro256 generator(kSeed);
+  for (std::size_t n : kLargeCitySizes) {
+    s21::Graph graph;
+    LoadRandomGraph(graph, n, generator);
+    s21::Ant ant;
+    ant.LoadGraph(graph);
+    for (std::size_t candidates : {std::size_t(0), std::size_t(20)}) {
+      s21::Ant::Options options;
+      options.max_iterations = 5;
+      options.candidate_list_size = candidates;
+      options.seed = kSeed;
+      ant.SetOptions(options);
+      double tours = double(options.number_of_ants * options.max_iterations);
+      benchmark.Run("AntConstruction",
+                    {{"n", double(n)}, {"candidates", double(candidates)}},
+                    tours, "tours/s", [&] { return ant.Solve(); });
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Benchmark::Options options;
+  std::string json_filename;
+  for (int i = 1; i < argc; ++i) {
+    std::string argument = argv[i];
+    auto value = argument.substr(argument.find('=') + 1);
+    if (argument.rfind("--json=", 0) == 0) {
+      json_filename = value;
+    } else if (argument.rfind("--filter=", 0) == 0) {
+      options.filter = value;
+    } else if (argument == "--perf") {
+      if (!s21::PerfCounters::Enable()) {
+        std::cerr << "perf_event_open is not available\n";
+        return 1;
+      } else if (!s21::PerfCounters::IsAvailable(s21::PerfCounters::kCycles)) {
+        std::cerr << "No hardware counters, counting the task clock only\n";
+      }
+    } else if (argument == "--affinity=compact") {
+      placement.affinity = s21::ThreadPool::Affinity::kCompact;
+    } else if (argument == "--affinity=scatter") {
+      placement.affinity = s21::ThreadPool::Affinity::kScatter;
+    } else if (argument.rfind("--min-time=", 0) == 0) {
+      options.min_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::duration<double>(std::stod(value)));
+    } else {
+      std::cerr << "Unknown argument: " << argument << '\n';
+      return 1;
+    }
+  }
+
+  Benchmark benchmark(options);
+  BenchGauss(benchmark);
+  BenchLargeGauss(benchmark);
+  BenchGrape(benchmark);
+  BenchLargeGrape(benchmark);
+  BenchAnt(benchmark);
+  BenchAntConstruction(benchmark);
+  benchmark.PrintTable();
+
+  if (!json_filename.empty()) {
+    std::ofstream file(json_filename);
+    benchmark.WriteJson(file);
+  }
+  return 0;
+}
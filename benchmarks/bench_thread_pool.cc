@@ -0,0 +1,70 @@
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include "common/thread_pool.h"
+
+namespace {
+
+constexpr unsigned kTasks = 200000;
+constexpr unsigned kTreeDepth = 17;
+
+std::atomic<unsigned> counter;
+
+void Spin() {
+  volatile unsigned x = 0;
+  for (unsigned i = 0; i < 64; ++i) {
+    x = x + i;
+  }
+  ++counter;
+}
+
+void SpawnTree(s21::ThreadPool& pool, unsigned depth) {
+  Spin();
+  if (depth > 0) {
+    pool.AddTask([&pool, depth] { SpawnTree(pool, depth - 1); });
+    pool.AddTask([&pool, depth] { SpawnTree(pool, depth - 1); });
+  }
+}
+
+template <class Function>
+double MeasureTasksPerSecond(Function&& f) {
+  counter = 0;
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return counter / std::chrono::duration<double>(end - start).count();
+}
+
+}  // namespace
+
+int main() {
+  std::size_t max_threads =
+      std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+  std::vector<std::size_t> sweep;
+  for (std::size_t threads = 1; threads < max_threads; threads *= 2) {
+    sweep.push_back(threads);
+  }
+  sweep.push_back(max_threads);
+
+  std::cout << "threads\texternal tasks/s\tnested tasks/s\n";
+  for (std::size_t threads : sweep) {
+    s21::ThreadPool pool(threads);
+    double external = MeasureTasksPerSecond([&pool] {
+      for (unsigned i = 0; i < kTasks; ++i) {
+        pool.AddTask(Spin);
+      }
+      pool.Join();
+    });
+    double nested = MeasureTasksPerSecond([&pool] {
+      pool.AddTask([&pool] { SpawnTree(pool, kTreeDepth); });
+      pool.Join();
+    });
+    std::cout << threads << '\t' << std::fixed << std::setprecision(0)
+              << external << "\t\t" << nested << '\n';
+  }
+
+  return 0;
+}
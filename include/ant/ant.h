@@ -1,12 +1,16 @@
 #ifndef A2_SIMPLENAVIGATOR_INCLUDE_ANT_ANT_H_
 #define A2_SIMPLENAVIGATOR_INCLUDE_ANT_ANT_H_
 
-#include <shared_mutex>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "common/matrix.h"
+#include "common/random.h"
 #include "common/thread_pool.h"
 #include "graph.h"
+#include "local_search.h"
 
 namespace s21 {
 
@@ -15,38 +19,195 @@ class Ant {
   using size_type = Graph::size_type;
   using tour_t = std::vector<size_type>;
   static constexpr size_type size_type_max = Graph::size_type_max;
+  using clock = std::chrono::steady_clock;
+
+  enum class LocalSearchMode { kNone, kIterationBest, kAllAnts };
+
+  // kAntSystem: every ant deposits 1 / length.
+  // kElitist: as kAntSystem, plus elite_weight / length on the best tour.
+  // kRankBased: the rank_size - 1 best ants deposit (rank_size - r) / length
+  //   and the best tour rank_size / length.
+  // kMaxMin: only the iteration's best ant deposits, and pheromone is kept in
+  //   [tau_min, tau_max] derived from the best length and max_min_p_best.
+  // kAntColonySystem: ants take the best candidate with probability acs_q0,
+  //   every edge decays towards tau0 by acs_local_evaporation as soon as an
+  //   ant crosses it, and only the best tour's edges evaporate and receive
+  //   pheromone. The ants of a colony then move in turn, one step each, on
+  //   a single thread; colonies of an island model still run concurrently.
+  enum class Variant {
+    kAntSystem,
+    kElitist,
+    kRankBased,
+    kMaxMin,
+    kAntColonySystem
+  };
+
+  struct Options {
+    Variant variant{Variant::kAntSystem};
+    double alpha{1.0};
+    double beta{2.0};
+    double evaporation_rate{0.5};
+    size_type number_of_ants{10};
+    size_type max_iterations{100};
+    // With a non-zero size, each step samples only among that many nearest
+    // neighbours of the current city and takes the unvisited city with the
+    // highest choice value once they are all visited. Pheromone is then kept
+    // per candidate edge, plus the other edges that received a deposit, so a
+    // colony needs O(n * size) memory. 0 considers every city, with n x n
+    // trails.
+    size_type candidate_list_size{};
+    // 2-opt/Or-opt on the iteration's best tour or on every ant's tour (in
+    // parallel when solving on a pool) before pheromone is deposited.
+    LocalSearchMode local_search{LocalSearchMode::kNone};
+    double elite_weight{10.0};
+    size_type rank_size{6};
+    double max_min_p_best{0.05};
+    double acs_q0{0.9};
+    double acs_local_evaporation{0.1};
+    // Island model: every colony keeps its own pheromone and tours, and
+    // every migration_interval iterations colony i adopts the best tour of
+    // colony i - 1 (in a ring) if it is shorter than its own. Solving on a
+    // pool runs the colonies concurrently, each one sequentially. The stop
+    // criteria below are then checked at migrations.
+    size_type colonies{1};
+    size_type migration_interval{10};
+    // Stop once the best tour has not improved for this many iterations
+    // (0 disables the check).
+    size_type stagnation_iterations{};
+    // Stop once the mean normalized entropy of the pheromone rows, in [0, 1],
+    // falls below this value (0 disables the check).
+    double min_entropy{};
+    // Every ant of every colony draws from its own xoshiro256++ stream
+    // derived from this seed, so a seed gives the same result whether or not
+    // the solve runs on a pool. 0 takes a new seed from std::random_device.
+    std::uint64_t seed{};
+  };
+
+  enum class StopReason { kIterations, kDeadline, kStagnation, kEntropy };
 
   struct TsmResult {
     tour_t vertices;
     double distance{};
+    size_type iterations{};
+    StopReason stop_reason{StopReason::kIterations};
+    std::uint64_t seed{};
+    // Best distance after every iteration.
+    std::vector<double> history;
   };
 
   Ant() = default;
-  void LoadGraph(Graph& graph);
+  // Ant keeps a pointer to the graph rather than a copy, so the graph must
+  // outlive it and be loaded again after it changes. The graph is never
+  // modified; Solve() builds the nearest-neighbour lists the options need in
+  // the Ant itself, so several Ants may share and solve one graph at once.
+  void LoadGraph(const Graph& graph);
+  // A temporary would be gone before Solve().
+  void LoadGraph(const Graph&& graph) = delete;
+  void SetOptions(const Options& options);
+  [[nodiscard]] const Options& GetOptions() const noexcept;
   TsmResult Solve(bool parallel = false);
+  TsmResult Solve(ThreadPool& pool);
+  // The deadline is checked between iterations: the running iteration is
+  // finished, and at least one iteration always runs.
+  TsmResult Solve(clock::time_point deadline, bool parallel = false);
+  TsmResult Solve(clock::time_point deadline, ThreadPool& pool);
+  // The pheromone a colony was left with by the last Solve(), expanded into
+  // an n x n matrix.
+  [[nodiscard]] Matrix<double> GetPheromone(size_type colony = 0) const;
 
  private:
-  tour_t ConstructTour();
-  void UpdatePheromone();
-  size_type CalculateTotalDistance(const tour_t& tour);
-  void ProcessPheromoneUpdate();
+  // The pheromone update of one iteration: every trail is scaled by keep,
+  // then each deposit sets tau = tau * decay + amount on the edges of its
+  // tour, in order.
+  struct Deposit {
+    const tour_t* tour;
+    double decay;
+    double amount;
+  };
 
-  void AddPheromoneValue(size_type i, size_type j, double value);
+  // The pheromone on an edge off the candidate list.
+  struct Trail {
+    size_type city;
+    double tau;
+  };
 
- private:
-  constexpr static double alpha = 1.0;  // Вес феромона
-  constexpr static double beta = 2.0;   // Вес эвристики
-  constexpr static double evaporation_rate =
-      0.5;  // Скорость испарения феромона
+  // The trail and choice matrices have a column per candidate (see
+  // ColumnCity()).
+  struct Colony {
+    Matrix<double> pheromone_mx;
+    // pheromone^alpha * heuristic, refreshed once per iteration so that tour
+    // construction does no transcendental work.
+    Matrix<double> choice_info_mx;
+    // With candidate lists: per row, the other edges that have received a
+    // deposit, and the pheromone shared by all the edges that never have.
+    std::vector<std::vector<Trail>> off_candidate;
+    double tau_rest{};
+    std::vector<tour_t> tours;
+    std::vector<size_type> tour_lengths;
+    std::vector<Xoshiro256> generators;
+    tour_t best_tour;
+    size_type best_tour_distance{size_type_max};
+    std::vector<Deposit> deposits;
+    double keep{};
+    double tau_min{};
+    double tau_max{};
+  };
+
+  TsmResult Run(clock::time_point deadline);
+  void InitializeColony(Colony& colony, Xoshiro256& streams);
+  void UpdateChoiceInfo(Colony& colony, size_type row_begin,
+                        size_type row_end);
+  void ConstructTour(const Colony& colony, tour_t& tour,
+                     Xoshiro256& generator);
+  void ConstructToursTogether(Colony& colony);
+  void StartTour(tour_t& tour, std::vector<double>& unvisited,
+                 Xoshiro256& generator);
+  size_type SelectNextCity(const Colony& colony, size_type current_city,
+                           std::vector<double>& unvisited,
+                           std::vector<double>& weights, Xoshiro256& generator);
+  void UpdateLocally(Colony& colony, size_type from, size_type to);
+  size_type SelectFallbackCity(const Colony& colony, size_type city,
+                               std::vector<double>& unvisited) const;
+  [[nodiscard]] size_type ColumnCity(size_type row, size_type column) const;
+  [[nodiscard]] size_type FindColumn(size_type from, size_type to) const;
+  double& FindTrail(Colony& colony, size_type from, size_type to);
+  [[nodiscard]] double ComputeHeuristic(size_type from, size_type to) const;
+  double RunIteration(Colony& colony, bool parallel);
+  void ImproveTours(Colony& colony, bool parallel);
+  void UpdateBestTour(Colony& colony);
+  void PrepareDeposits(Colony& colony);
+  void UpdatePheromoneRows(Colony& colony, size_type row_begin,
+                           size_type row_end);
+  void MigrateBestTours();
+  [[nodiscard]] double CalculateEntropy(const Colony& colony,
+                                        size_type i) const;
+  size_type CalculateTotalDistance(const tour_t& tour);
+  size_type CalculateNearestNeighbourDistance();
+  template <class Function>
+  void ForEach(size_type count, bool parallel, Function function);
+
+  static double ComputeWeights(const double* choice, const double* unvisited,
+                               double* weights, size_type size);
+  static size_type SelectCity(const std::vector<double>& weights,
+                              double target);
+  static size_type SelectBestCity(const double* choice,
+                                  const double* unvisited, size_type size);
 
  private:
   bool parallel_{};
-  std::unique_ptr<ThreadPool> pool_;
-  Graph graph_;
-  size_type number_of_ants{};
-  size_type max_iterations{};
-  Matrix<double> pheromone_mx_;
-  mutable std::vector<std::vector<std::mutex>> mu_;
+  ThreadPool* pool_{};
+  const Graph* graph_{};
+  NeighbourLists neighbours_;
+  Options options_;
+  std::unique_ptr<LocalSearch> local_search_;
+  // The candidate list size in use, or 0 when every city is a column.
+  size_type candidates_{};
+  // (1 / distance)^beta per column, fixed for the graph and shared by the
+  // colonies; empty for a coordinate graph without candidate lists.
+  Matrix<double> heuristic_mx_;
+  // The initial pheromone; kAntColonySystem's local update decays towards it.
+  double tau0_{};
+  std::vector<Colony> colonies_;
 };
 
 }  // namespace s21
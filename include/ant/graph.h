@@ -1,34 +1,146 @@
 #ifndef A2_SIMPLENAVIGATOR_INCLUDE_ANT_GRAPH_H_
 #define A2_SIMPLENAVIGATOR_INCLUDE_ANT_GRAPH_H_
 
+#include <cmath>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <limits>
 #include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+#include "common/binary_format.h"
+#include "common/mapped_file.h"
 #include "common/matrix.h"
 
 namespace s21 {
 
-class Graph {
+// A weighted graph on vertices 0..GetSize() - 1. Symmetric graphs are stored
+// as the lower triangle (n(n + 1) / 2 weights), others as the full n x n
+// matrix in row-major order. A zero weight off the diagonal in the file is a
+// missing edge and reads back as weight_max, so loading a text or TSPLIB file
+// throws on weights of weight_max or more.
+//
+// SaveGraphToBinaryFile() writes the weights as stored (binary_format.h);
+// LoadGraphFromFile() maps such a file and reads the weights in place, and
+// copies of the graph share them. Binary matrix files (Matrix::
+// SaveMatrixToBinaryFile) are rejected rather than parsed as text.
+//
+// A text file is parsed in one pass into the lower triangle: the weights
+// above the diagonal go straight to their mirrored places, where the later
+// rows check them. At the first mismatch the rows read so far are expanded
+// and the rest is read into the full matrix.
+//
+// A TSPLIB file with EDGE_WEIGHT_TYPE EUC_2D or GEO keeps only the node
+// coordinates (kCoordinates) and GetWeight() computes the TSPLIB distance on
+// every call, so loading and memory are O(n).
+//
+// The definitions live in graph.cc, instantiated for std::uint32_t only: Ant,
+// NeighbourLists and LocalSearch all take a Graph.
+template <class W>
+class BasicGraph {
  public:
   using size_type = std::size_t;
-  using AdjacencyMatrix = Matrix<size_type>;
+  using weight_type = W;
+  using AdjacencyMatrix = Matrix<weight_type>;
   static constexpr size_type size_type_max =
       std::numeric_limits<size_type>::max();
+  static constexpr weight_type weight_max =
+      std::numeric_limits<weight_type>::max();
+
+  enum class Layout { kFull, kSymmetric, kCoordinates };
 
   void LoadGraphFromFile(const std::string& filename);
+  void LoadTsplibFromFile(const std::string& filename);
+  // Coordinate graphs are written as their symmetric weights.
+  void SaveGraphToBinaryFile(const std::string& filename) const;
 
   [[nodiscard]] bool IsComplete() const noexcept;
   [[nodiscard]] bool IsLoaded() const noexcept;
   [[nodiscard]] bool IsWeighted() const noexcept;
-  [[nodiscard]] AdjacencyMatrix GetAdjacencyMatrix() const noexcept;
-  [[nodiscard]] size_type GetWeight(size_type vertex_a,
-                                    size_type vertex_b) const;
+  [[nodiscard]] Layout GetLayout() const noexcept;
+  // Expands the weights into a new n x n matrix.
+  [[nodiscard]] AdjacencyMatrix GetAdjacencyMatrix() const;
+  [[nodiscard]] weight_type GetWeight(size_type vertex_a,
+                                      size_type vertex_b) const noexcept;
   [[nodiscard]] size_type GetSize() const noexcept;
 
  private:
-  AdjacencyMatrix adjacency_matrix;
+  enum class Metric { kEuclidean, kGeographical };
+
+  void Clear();
+  void LoadText(std::string_view text);
+  bool LoadBinary(const std::shared_ptr<const MappedFile>& file);
+  [[nodiscard]] size_type GetWeightCount() const noexcept;
+  [[nodiscard]] weight_type ComputeDistance(size_type vertex_a,
+                                            size_type vertex_b) const noexcept;
+
+  size_type size_{};
+  Layout layout_{Layout::kFull};
+  // Either a std::vector<weight_type> or a mapped file; never modified.
+  std::shared_ptr<const void> storage_;
+  const weight_type* weights_{};
+  // kCoordinates: x and y, or latitude and longitude in radians for GEO.
+  Metric metric_{Metric::kEuclidean};
+  std::vector<double> x_;
+  std::vector<double> y_;
+};
+
+template <class W>
+inline typename BasicGraph<W>::weight_type BasicGraph<W>::GetWeight(
+    size_type vertex_a, size_type vertex_b) const noexcept {
+  if (layout_ == Layout::kFull) {
+    return weights_[vertex_a * size_ + vertex_b];
+  } else if (layout_ == Layout::kCoordinates) {
+    return ComputeDistance(vertex_a, vertex_b);
+  }
+  if (vertex_a < vertex_b) {
+    std::swap(vertex_a, vertex_b);
+  }
+  return weights_[vertex_a * (vertex_a + 1) / 2 + vertex_b];
+}
+
+template <class W>
+inline typename BasicGraph<W>::weight_type BasicGraph<W>::ComputeDistance(
+    size_type vertex_a, size_type vertex_b) const noexcept {
+  if (vertex_a == vertex_b) {
+    return weight_type();
+  } else if (metric_ == Metric::kEuclidean) {
+    double dx = x_[vertex_a] - x_[vertex_b];
+    double dy = y_[vertex_a] - y_[vertex_b];
+    return weight_type(std::lround(std::sqrt(dx * dx + dy * dy)));
+  }
+  constexpr double kEarthRadius = 6378.388;
+  double q1 = std::cos(y_[vertex_a] - y_[vertex_b]);
+  double q2 = std::cos(x_[vertex_a] - x_[vertex_b]);
+  double q3 = std::cos(x_[vertex_a] + x_[vertex_b]);
+  return weight_type(std::int64_t(
+      kEarthRadius * std::acos(0.5 * ((1.0 + q1) * q2 - (1.0 - q1) * q3)) +
+      1.0));
+}
+
+extern template class BasicGraph<std::uint32_t>;
+
+using Graph = BasicGraph<std::uint32_t>;
+
+// For every vertex of a graph, the `count` other vertices closest to it in
+// ascending order of weight (clamped to GetSize() - 1). Kept apart from the
+// graph, so that solvers sharing a const Graph build their own.
+class NeighbourLists {
+ public:
+  using size_type = Graph::size_type;
+
+  NeighbourLists() = default;
+  NeighbourLists(const Graph& graph, size_type count);
+
+  [[nodiscard]] size_type GetCount() const noexcept;
+  [[nodiscard]] const size_type* Get(size_type vertex) const;
+
+ private:
+  std::vector<size_type> neighbours_;
+  size_type count_{};
 };
 
 }  // namespace s21
@@ -0,0 +1,47 @@
+#ifndef A2_SIMPLENAVIGATOR_INCLUDE_ANT_LOCAL_SEARCH_H_
+#define A2_SIMPLENAVIGATOR_INCLUDE_ANT_LOCAL_SEARCH_H_
+
+#include <vector>
+
+#include "graph.h"
+
+namespace s21 {
+
+// 2-opt and Or-opt (segments of up to kMaxSegment cities, either
+// orientation) over the graph's nearest-neighbour lists with don't-look bits:
+// only cities next to a changed edge are examined again, and candidate
+// partners are tried in order of distance until no move can gain. Both moves
+// assume symmetric weights, so Improve() leaves tours of asymmetric graphs
+// untouched. Improve() keeps its state on the stack and may run on several
+// tours concurrently.
+class LocalSearch {
+ public:
+  using size_type = Graph::size_type;
+  using tour_t = std::vector<size_type>;
+  static constexpr size_type kMaxSegment = 3;
+  static constexpr size_type kDefaultNeighbours = 10;
+
+  // The graph and the neighbour lists must outlive the object.
+  LocalSearch(const Graph& graph, const NeighbourLists& neighbours);
+
+  // Returns true if the tour was shortened.
+  bool Improve(tour_t& tour) const;
+
+ private:
+  struct State;
+
+  bool TryTwoOpt(State& state, size_type city) const;
+  bool TryOrOpt(State& state, size_type city) const;
+  void Reverse(State& state, size_type from, size_type to) const;
+  void MoveSegment(State& state, size_type first, size_type length,
+                   size_type after, bool reversed) const;
+  [[nodiscard]] double Weight(size_type a, size_type b) const;
+
+  const Graph& graph_;
+  const NeighbourLists& neighbours_;
+  bool symmetric_{};
+};
+
+}  // namespace s21
+
+#endif  // A2_SIMPLENAVIGATOR_INCLUDE_ANT_LOCAL_SEARCH_H_
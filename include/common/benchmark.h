@@ -0,0 +1,112 @@
+#ifndef A2_SIMPLENAVIGATOR_INCLUDE_COMMON_BENCHMARK_H_
+#define A2_SIMPLENAVIGATOR_INCLUDE_COMMON_BENCHMARK_H_
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/perf_counters.h"
+
+namespace s21 {
+
+// Keeps the compiler from discarding a result it can prove unused.
+template <class T>
+inline void DoNotOptimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void ClobberMemory() { asm volatile("" : : : "memory"); }
+
+// Times a case sample by sample: after the warm-up calls it keeps calling
+// until both min_iterations and min_time are reached, or max_iterations, and
+// reports the distribution of the per-call times. Cases whose name does not
+// contain Options::filter are skipped. While PerfCounters are enabled, the
+// phase counts of the timed calls are kept with the result.
+class Benchmark {
+ public:
+  using clock = std::chrono::steady_clock;
+  using Parameters = std::vector<std::pair<std::string, double>>;
+
+  struct Options {
+    std::size_t warmup_iterations{1};
+    std::size_t min_iterations{5};
+    std::size_t max_iterations{1000};
+    std::chrono::nanoseconds min_time{std::chrono::milliseconds(200)};
+    std::string filter;
+  };
+
+  struct Result {
+    std::string name;
+    Parameters parameters;
+    std::size_t iterations{};
+    double min_ns{};
+    double median_ns{};
+    double p99_ns{};
+    double mean_ns{};
+    // work per call / median time, e.g. GFLOP/s or tours/s.
+    double throughput{};
+    std::string throughput_unit;
+    // Totals over all timed calls.
+    std::vector<PerfCounters::Sample> phases;
+  };
+
+  Benchmark() = default;
+  explicit Benchmark(const Options& options);
+
+  // `work` is the amount of work one call does, in the units of `unit`
+  // times seconds: GFLOP for "GFLOP/s", tours for "tours/s".
+  template <class Function>
+  void Run(const std::string& name, const Parameters& parameters, double work,
+           const std::string& unit, Function&& function);
+
+  [[nodiscard]] const std::vector<Result>& GetResults() const noexcept;
+  void PrintTable(std::ostream& os = std::cout) const;
+  void WriteJson(std::ostream& os) const;
+
+ private:
+  void AddResult(const std::string& name, const Parameters& parameters,
+                 double work, const std::string& unit,
+                 std::vector<double>& samples);
+
+  Options options_;
+  std::vector<Result> results_;
+};
+
+template <class Function>
+void Benchmark::Run(const std::string& name, const Parameters& parameters,
+                    double work, const std::string& unit,
+                    Function&& function) {
+  if (name.find(options_.filter) == std::string::npos) {
+    return;
+  }
+  for (std::size_t i = 0; i < options_.warmup_iterations; ++i) {
+    DoNotOptimize(function());
+  }
+
+  bool counting = PerfCounters::IsEnabled();
+  if (counting) {
+    PerfCounters::Reset();
+  }
+  std::vector<double> samples;
+  auto start = clock::now();
+  while (samples.size() < options_.max_iterations &&
+         (samples.size() < options_.min_iterations ||
+          clock::now() - start < options_.min_time)) {
+    auto begin = clock::now();
+    DoNotOptimize(function());
+    ClobberMemory();
+    auto end = clock::now();
+    samples.push_back(
+        std::chrono::duration<double, std::nano>(end - begin).count());
+  }
+  AddResult(name, parameters, work, unit, samples);
+  if (counting) {
+    results_.back().phases = PerfCounters::GetSamples();
+  }
+}
+
+}  // namespace s21
+
+#endif  // A2_SIMPLENAVIGATOR_INCLUDE_COMMON_BENCHMARK_H_
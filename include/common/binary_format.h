@@ -0,0 +1,109 @@
+#ifndef A2_SIMPLENAVIGATOR_INCLUDE_COMMON_BINARY_FORMAT_H_
+#define A2_SIMPLENAVIGATOR_INCLUDE_COMMON_BINARY_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace s21 {
+
+enum class DataType : std::uint32_t {
+  kFloat64 = 1,
+  kFloat32 = 2,
+  kUint32 = 3,
+  kUint64 = 4
+};
+
+// kMatrix is a dense row-major matrix. The graph layouts hold graph weights
+// as stored by BasicGraph (missing edges already weight_max): kGraphFull is
+// row-major n x n, kGraphSymmetric the lower triangle row by row.
+enum class BinaryLayout : std::uint32_t {
+  kMatrix = 0,
+  kGraphFull = 1,
+  kGraphSymmetric = 2
+};
+
+// A 64-byte header in native byte order, then the data at data_offset, a
+// multiple of alignment, so that a mapped file can be used in place.
+struct BinaryHeader {
+  static constexpr char kMagic[8] = {'S', '2', '1', 'M', 'A', 'T', 'R', 'X'};
+  static constexpr std::uint32_t kVersion = 1;
+  static constexpr std::uint32_t kByteOrder = 0x01020304;
+  static constexpr std::uint64_t kAlignment = 64;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  DataType data_type;
+  BinaryLayout layout;
+  std::uint64_t rows;
+  std::uint64_t cols;
+  std::uint64_t alignment;
+  std::uint64_t data_offset;
+  std::uint64_t data_size;
+};
+
+static_assert(sizeof(BinaryHeader) == 64, "The header must be 64 bytes");
+
+template <class T>
+struct DataTypeOf;
+template <>
+struct DataTypeOf<double> {
+  static constexpr DataType value = DataType::kFloat64;
+};
+template <>
+struct DataTypeOf<float> {
+  static constexpr DataType value = DataType::kFloat32;
+};
+template <>
+struct DataTypeOf<std::uint32_t> {
+  static constexpr DataType value = DataType::kUint32;
+};
+template <>
+struct DataTypeOf<std::uint64_t> {
+  static constexpr DataType value = DataType::kUint64;
+};
+
+// Whether T has a DataType, i.e. can be stored in a binary file.
+template <class T, class = void>
+struct HasDataType : std::false_type {};
+template <class T>
+struct HasDataType<T, std::void_t<decltype(DataTypeOf<T>::value)>>
+    : std::true_type {};
+
+void WriteBinaryFile(const std::string& filename, DataType data_type,
+                     BinaryLayout layout, std::uint64_t rows,
+                     std::uint64_t cols, const void* data, std::size_t size);
+
+// std::nullopt if the file does not start with the magic. A file that does
+// but has another version, byte order or a data range outside the file
+// throws.
+std::optional<BinaryHeader> ReadBinaryHeader(std::string_view file);
+
+// The number of values the header's layout and dimensions describe: rows x
+// cols, or the lower triangle of a rows x rows matrix for kGraphSymmetric.
+// Throws if the count or its size in bytes does not fit in 64 bits.
+std::uint64_t GetBinaryValueCount(const BinaryHeader& header,
+                                  std::size_t value_size);
+
+// The data of a file whose header was read by ReadBinaryHeader, checked to
+// hold GetBinaryValueCount() values of type T at a suitably aligned offset.
+template <class T>
+const T* GetBinaryData(std::string_view file, const BinaryHeader& header) {
+  if (header.data_type != DataTypeOf<T>::value) {
+    throw std::invalid_argument("Incorrect data type");
+  } else if (header.data_offset % alignof(T) != 0 ||
+             header.data_size !=
+                 GetBinaryValueCount(header, sizeof(T)) * sizeof(T)) {
+    throw std::invalid_argument("Incorrect data format");
+  }
+  return reinterpret_cast<const T*>(file.data() + header.data_offset);
+}
+
+}  // namespace s21
+
+#endif  // A2_SIMPLENAVIGATOR_INCLUDE_COMMON_BINARY_FORMAT_H_
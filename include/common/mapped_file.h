@@ -0,0 +1,44 @@
+#ifndef A2_SIMPLENAVIGATOR_INCLUDE_COMMON_MAPPED_FILE_H_
+#define A2_SIMPLENAVIGATOR_INCLUDE_COMMON_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace s21 {
+
+// A whole file mapped read-only into memory. The pages are shared with the
+// page cache, so opening a file that is already cached copies nothing.
+//
+// The access pattern is passed to madvise(). kSequential suits a file that
+// is read once from start to end and lets the kernel drop pages behind the
+// reader; a mapping kept to back a live view should be kNormal, or kRandom
+// if it is read in no particular order.
+class MappedFile {
+ public:
+  enum class Access { kNormal, kSequential, kRandom };
+
+  explicit MappedFile(const std::string& filename,
+                      Access access = Access::kSequential);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  ~MappedFile();
+
+  [[nodiscard]] const char* GetData() const noexcept;
+  [[nodiscard]] std::size_t GetSize() const noexcept;
+  [[nodiscard]] std::string_view GetView() const noexcept;
+  // Changes the advice once it is known how the file will be read.
+  void Advise(Access access) const noexcept;
+
+ private:
+  void Release() noexcept;
+
+  const char* data_{};
+  std::size_t size_{};
+};
+
+}  // namespace s21
+
+#endif  // A2_SIMPLENAVIGATOR_INCLUDE_COMMON_MAPPED_FILE_H_
@@ -2,16 +2,47 @@
 #define A2_SIMPLENAVIGATOR_INCLUDE_COMMON_MATRIX_H_
 
 #include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <random>
 #include <sstream>
+#include <string_view>
 #include <vector>
 
+#include "common/binary_format.h"
+#include "common/mapped_file.h"
+#include "common/thread_pool.h"
+
 namespace s21 {
 
+// std::allocator, except that elements constructed without arguments are
+// default-initialized: a vector<double> of n elements is allocated but not
+// written, so whichever thread writes a page first decides where it lives.
+template <class T>
+struct DefaultInitAllocator : std::allocator<T> {
+  template <class U>
+  struct rebind {
+    using other = DefaultInitAllocator<U>;
+  };
+
+  using std::allocator<T>::allocator;
+
+  template <class U>
+  void construct(U* pointer) {
+    ::new (static_cast<void*>(pointer)) U;
+  }
+  template <class U, class... Args>
+  void construct(U* pointer, Args&&... args) {
+    ::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+  }
+};
+
 template <class T>
 class Matrix {
  public:
@@ -22,8 +53,16 @@ class Matrix {
   Matrix() = default;
   Matrix(i_type rows, i_type cols);
   explicit Matrix(i_type rows, i_type cols, T value);
+  // The storage has its own allocator (see DefaultInitAllocator), so data
+  // is copied either way.
   Matrix(i_type rows, i_type cols, const base& data);
   Matrix(i_type rows, i_type cols, base&& data);
+  // Zero-fill or copy the rows in ForEachRowBlock(), so that every worker
+  // first touches the block of rows it later gets from ForEachRowBlock().
+  // Worth it only on a pool with pinned workers (GetWorkerCpu() >= 0), and
+  // only if the rows are then processed through ForEachRowBlock().
+  Matrix(i_type rows, i_type cols, ThreadPool& pool);
+  Matrix(const Matrix& other, ThreadPool& pool);
 
   T& operator()(i_type row, i_type col);
   const T& operator()(i_type row, i_type col) const;
@@ -44,15 +83,55 @@ class Matrix {
   void Print(std::ostream& os = std::cout) const;
   void PrintFull(std::ostream& os = std::cout) const;
   void ReadFull(std::istream& is = std::cin);
+  // The ReadFull format: "rows cols", then lines of exactly cols numbers
+  // (blank lines are skipped). Parsed with std::from_chars straight into
+  // storage reserved for the smaller of rows x cols and the values the text
+  // can hold; the pool overload splits the text at line boundaries and
+  // parses the pieces concurrently. Throws "Incorrect data format" on a
+  // header whose size overflows and on malformed or missing values.
+  void Parse(std::string_view text);
+  void Parse(std::string_view text, ThreadPool& pool);
+  // Parses the same format without keeping the matrix: header(rows, cols)
+  // is called first, then row(i, values) with the cols values of every row
+  // in order.
+  template <class Header, class Row>
+  static void ParseRows(std::string_view text, Header header, Row row);
   void Generate(i_type rows, i_type cols);
+  // Maps the file; a binary file (see binary_format.h) is copied as is,
+  // anything else, or any file if T has no DataType, is parsed with Parse().
   void LoadMatrixFromFile(std::string filename);
+  void LoadMatrixFromFile(std::string filename, ThreadPool& pool);
+  void SaveMatrixToBinaryFile(const std::string& filename) const;
 
   void SwapRows(int i, int j);
+  // Calls function(first, last) on blocks of rows in a kStaticPinned
+  // ParallelFor(), each on the worker that the pool constructors have
+  // touched it from.
+  template <class Function>
+  void ForEachRowBlock(ThreadPool& pool, Function&& function) const;
 
  private:
+  template <class>
+  friend class MatrixView;
+
+  using storage = std::vector<T, DefaultInitAllocator<T>>;
+
+  static constexpr std::size_t kParseChunkBytes = 1 << 20;
+
+  bool LoadBinary(std::string_view file);
+  static const char* ParseHeader(const char* first, const char* last,
+                                 i_type& rows, i_type& cols);
+  // Stops after the line that brings values to `limit`; first is left at
+  // the next line.
+  static bool ParseLines(const char*& first, const char* last, i_type cols,
+                         i_type limit, storage& values);
+  template <class Number>
+  static const char* ParseNumber(const char* first, const char* last,
+                                 Number& value);
+
   i_type rows_{};
   i_type cols_{};
-  base data_;
+  storage data_;
 };
 
 template <class T>
@@ -66,10 +145,8 @@ void Matrix<T>::SwapRows(int i, int j) {
 }
 
 template <class T>
-Matrix<T>::Matrix(i_type rows, i_type cols) : rows_(rows), cols_(cols) {
-  std::vector<T> new_vector(rows_ * cols_);
-  data_ = std::move(new_vector);
-}
+Matrix<T>::Matrix(i_type rows, i_type cols)
+    : rows_(rows), cols_(cols), data_(rows * cols, T()) {}
 
 template <class T>
 Matrix<T>::Matrix(i_type rows, i_type cols, T value)
@@ -77,11 +154,37 @@ Matrix<T>::Matrix(i_type rows, i_type cols, T value)
 
 template <class T>
 Matrix<T>::Matrix(i_type rows, i_type cols, const base& data)
-    : rows_(rows), cols_(cols), data_(data) {}
+    : rows_(rows), cols_(cols), data_(data.begin(), data.end()) {}
 
 template <class T>
 Matrix<T>::Matrix(i_type rows, i_type cols, base&& data)
-    : rows_(rows), cols_(cols), data_(data) {}
+    : Matrix(rows, cols, static_cast<const base&>(data)) {}
+
+template <class T>
+Matrix<T>::Matrix(i_type rows, i_type cols, ThreadPool& pool)
+    : rows_(rows), cols_(cols), data_(rows * cols) {
+  ForEachRowBlock(pool, [this](i_type first, i_type last) {
+    std::fill(data_.begin() + first * cols_, data_.begin() + last * cols_,
+              T());
+  });
+}
+
+template <class T>
+Matrix<T>::Matrix(const Matrix& other, ThreadPool& pool)
+    : rows_(other.rows_), cols_(other.cols_), data_(other.data_.size()) {
+  ForEachRowBlock(pool, [this, &other](i_type first, i_type last) {
+    std::copy(other.data_.begin() + first * cols_,
+              other.data_.begin() + last * cols_,
+              data_.begin() + first * cols_);
+  });
+}
+
+template <class T>
+template <class Function>
+void Matrix<T>::ForEachRowBlock(ThreadPool& pool, Function&& function) const {
+  pool.ParallelFor(0, rows_, 1, std::forward<Function>(function),
+                   ThreadPool::Schedule::kStaticPinned);
+}
 
 template <class T>
 struct Matrix<T>::ReadRow {
@@ -231,14 +334,214 @@ void Matrix<T>::Generate(i_type rows, i_type cols) {
                 [&dist, &gen](T& value) { value = dist(gen); });
 }
 
+template <class T>
+void Matrix<T>::Parse(std::string_view text) {
+  const char* last = text.data() + text.size();
+  i_type rows = 0;
+  i_type cols = 0;
+  const char* body = ParseHeader(text.data(), last, rows, cols);
+  storage values;
+  values.reserve(std::min(rows * cols, text.size() / 2));
+
+  if (!ParseLines(body, last, cols, rows * cols, values) ||
+      values.size() < rows * cols) {
+    throw std::invalid_argument("Incorrect data format");
+  }
+  rows_ = rows;
+  cols_ = cols;
+  data_ = std::move(values);
+}
+
+template <class T>
+void Matrix<T>::Parse(std::string_view text, ThreadPool& pool) {
+  const char* last = text.data() + text.size();
+  i_type rows = 0;
+  i_type cols = 0;
+  const char* body = ParseHeader(text.data(), last, rows, cols);
+  auto size = std::size_t(last - body);
+  auto chunks = std::min(pool.GetThreadCount(), size / kParseChunkBytes);
+  if (chunks <= 1) {
+    Parse(text);
+    return;
+  }
+
+  std::vector<const char*> bounds(chunks + 1, last);
+  bounds[0] = body;
+  for (std::size_t chunk = 1; chunk < chunks; ++chunk) {
+    const char* split = body + size * chunk / chunks;
+    const char* eol =
+        static_cast<const char*>(std::memchr(split, '\n', last - split));
+    bounds[chunk] = eol ? eol + 1 : last;
+  }
+  std::vector<storage> pieces(chunks);
+  std::vector<char> valid(chunks);
+  pool.ParallelFor(0, chunks, 1, [&](std::size_t first, std::size_t last) {
+    for (std::size_t chunk = first; chunk < last; ++chunk) {
+      const char* begin = bounds[chunk];
+      auto bytes = std::size_t(bounds[chunk + 1] - begin);
+      pieces[chunk].reserve(std::min(rows * cols, bytes / 2));
+      valid[chunk] = ParseLines(begin, bounds[chunk + 1], cols, rows * cols,
+                                pieces[chunk]);
+    }
+  });
+
+  // A piece holds the whole lines before its first malformed one; values past
+  // the end of the matrix are ignored, as the sequential parser stops there.
+  // A malformed line is an error only if the matrix was not full before it.
+  storage values;
+  values.reserve(std::min(rows * cols, text.size() / 2));
+  for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+    auto need = rows * cols - values.size();
+    if (!valid[chunk] && pieces[chunk].size() < need) {
+      throw std::invalid_argument("Incorrect data format");
+    }
+    auto take = std::min(pieces[chunk].size(), need);
+    values.insert(values.end(), pieces[chunk].begin(),
+                  pieces[chunk].begin() + take);
+    if (values.size() == rows * cols) {
+      break;
+    }
+  }
+  if (values.size() < rows * cols) {
+    throw std::invalid_argument("Incorrect data format");
+  }
+  rows_ = rows;
+  cols_ = cols;
+  data_ = std::move(values);
+}
+
+template <class T>
+template <class Header, class Row>
+void Matrix<T>::ParseRows(std::string_view text, Header header, Row row) {
+  const char* last = text.data() + text.size();
+  i_type rows = 0;
+  i_type cols = 0;
+  const char* first = ParseHeader(text.data(), last, rows, cols);
+  header(rows, cols);
+  storage values;
+  values.reserve(std::min(cols, text.size() / 2));
+  for (i_type i = 0; i < rows; ++i) {
+    values.clear();
+    if (!ParseLines(first, last, cols, cols, values) || values.size() < cols) {
+      throw std::invalid_argument("Incorrect data format");
+    }
+    row(i, values.data());
+  }
+}
+
+template <class T>
+const char* Matrix<T>::ParseHeader(const char* first, const char* last,
+                                   i_type& rows, i_type& cols) {
+  auto skip = [last](const char* p) {
+    while (p != last && std::isspace(static_cast<unsigned char>(*p))) {
+      ++p;
+    }
+    return p;
+  };
+  first = ParseNumber(skip(first), last, rows);
+  if (first) {
+    first = ParseNumber(skip(first), last, cols);
+  }
+  if (!first || (cols != 0 && rows * cols / cols != rows)) {
+    throw std::invalid_argument("Incorrect data format");
+  }
+  return first;
+}
+
+template <class T>
+bool Matrix<T>::ParseLines(const char*& first, const char* last, i_type cols,
+                           i_type limit, storage& values) {
+  while (first != last && values.size() < limit) {
+    auto eol = static_cast<const char*>(std::memchr(first, '\n', last - first));
+    if (!eol) {
+      eol = last;
+    }
+    auto line = values.size();
+    i_type count = 0;
+    for (;;) {
+      while (first != eol && (*first == ' ' || *first == '\t' ||
+                              *first == '\r' || *first == '\v' ||
+                              *first == '\f')) {
+        ++first;
+      }
+      if (first == eol) {
+        break;
+      }
+      T value{};
+      if (count == cols || !(first = ParseNumber(first, eol, value))) {
+        values.resize(line);
+        return false;
+      }
+      values.push_back(value);
+      ++count;
+    }
+    if (count != 0 && count != cols) {
+      values.resize(line);
+      return false;
+    }
+    first = eol == last ? last : eol + 1;
+  }
+  return true;
+}
+
+template <class T>
+template <class Number>
+const char* Matrix<T>::ParseNumber(const char* first, const char* last,
+                                   Number& value) {
+  // from_chars takes no '+', so skip one, but only before the digits: "+-5"
+  // is not a number.
+  if (last - first > 1 && *first == '+' &&
+      (std::isdigit(static_cast<unsigned char>(first[1])) ||
+       first[1] == '.')) {
+    ++first;
+  }
+  auto [end, error] = std::from_chars(first, last, value);
+  if (error != std::errc() ||
+      (end != last && !std::isspace(static_cast<unsigned char>(*end)))) {
+    return nullptr;
+  }
+  return end;
+}
+
 template <class T>
 void Matrix<T>::LoadMatrixFromFile(std::string filename) {
-  std::ifstream file(filename);
+  MappedFile file(filename);
+  if (!LoadBinary(file.GetView())) {
+    Parse(file.GetView());
+  }
+}
 
-  if (file.is_open()) {
-    ReadFull(file);
+template <class T>
+void Matrix<T>::LoadMatrixFromFile(std::string filename, ThreadPool& pool) {
+  MappedFile file(filename);
+  if (!LoadBinary(file.GetView())) {
+    Parse(file.GetView(), pool);
+  }
+}
+
+template <class T>
+void Matrix<T>::SaveMatrixToBinaryFile(const std::string& filename) const {
+  WriteBinaryFile(filename, DataTypeOf<T>::value, BinaryLayout::kMatrix, rows_,
+                  cols_, data_.data(), data_.size() * sizeof(T));
+}
+
+template <class T>
+bool Matrix<T>::LoadBinary(std::string_view file) {
+  // A type without a DataType has no binary files: the file is parsed.
+  if constexpr (!HasDataType<T>::value) {
+    return false;
   } else {
-    throw std::runtime_error("The file cannot be opened");
+    auto header = ReadBinaryHeader(file);
+    if (!header) {
+      return false;
+    } else if (header->layout != BinaryLayout::kMatrix) {
+      throw std::invalid_argument("Incorrect data format");
+    }
+    const T* data = GetBinaryData<T>(file, *header);
+    data_.assign(data, data + GetBinaryValueCount(*header, sizeof(T)));
+    rows_ = header->rows;
+    cols_ = header->cols;
+    return true;
   }
 }
 
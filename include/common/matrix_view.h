@@ -0,0 +1,125 @@
+#ifndef A2_SIMPLENAVIGATOR_INCLUDE_COMMON_MATRIX_VIEW_H_
+#define A2_SIMPLENAVIGATOR_INCLUDE_COMMON_MATRIX_VIEW_H_
+
+#include <memory>
+#include <string>
+
+#include "common/binary_format.h"
+#include "common/mapped_file.h"
+#include "common/matrix.h"
+
+namespace s21 {
+
+// A read-only matrix backed by a mapped binary file: Map() reads only the
+// header, and the pages are shared with every other process mapping the
+// same file. A view can also own a Matrix moved into it, so that readers
+// take either without a copy. Copies of a view share the storage.
+template <class T>
+class MatrixView {
+ public:
+  static_assert(HasDataType<T>::value, "T must have a DataType");
+
+  using i_type = std::size_t;
+
+  MatrixView() = default;
+  explicit MatrixView(Matrix<T> matrix);
+  static MatrixView Map(const std::string& filename);
+  // Maps a binary file like Map(); any other file is parsed into a Matrix
+  // that the view owns.
+  static MatrixView Load(const std::string& filename);
+
+  [[nodiscard]] i_type GetRows() const noexcept;
+  [[nodiscard]] i_type GetCols() const noexcept;
+  [[nodiscard]] const T* GetData() const noexcept;
+  const T& operator()(i_type row, i_type col) const;
+  const T* operator[](i_type row) const;
+  [[nodiscard]] Matrix<T> ToMatrix() const;
+
+ private:
+  static MatrixView Map(std::shared_ptr<const MappedFile> file);
+
+  std::shared_ptr<const void> storage_;
+  const T* data_{};
+  i_type rows_{};
+  i_type cols_{};
+};
+
+template <class T>
+MatrixView<T>::MatrixView(Matrix<T> matrix)
+    : rows_(matrix.rows_), cols_(matrix.cols_) {
+  auto owned = std::make_shared<const Matrix<T>>(std::move(matrix));
+  data_ = owned->data_.data();
+  storage_ = std::move(owned);
+}
+
+template <class T>
+MatrixView<T> MatrixView<T>::Map(const std::string& filename) {
+  return Map(std::make_shared<const MappedFile>(filename,
+                                                MappedFile::Access::kNormal));
+}
+
+template <class T>
+MatrixView<T> MatrixView<T>::Load(const std::string& filename) {
+  auto file = std::make_shared<const MappedFile>(filename,
+                                                 MappedFile::Access::kNormal);
+  if (ReadBinaryHeader(file->GetView())) {
+    return Map(std::move(file));
+  }
+  file->Advise(MappedFile::Access::kSequential);
+  Matrix<T> matrix;
+  matrix.Parse(file->GetView());
+  return MatrixView(std::move(matrix));
+}
+
+template <class T>
+MatrixView<T> MatrixView<T>::Map(std::shared_ptr<const MappedFile> file) {
+  auto header = ReadBinaryHeader(file->GetView());
+  if (!header || header->layout != BinaryLayout::kMatrix) {
+    throw std::invalid_argument("Incorrect data format");
+  }
+
+  MatrixView view;
+  view.data_ = GetBinaryData<T>(file->GetView(), *header);
+  view.rows_ = header->rows;
+  view.cols_ = header->cols;
+  view.storage_ = std::move(file);
+  return view;
+}
+
+template <class T>
+typename MatrixView<T>::i_type MatrixView<T>::GetRows() const noexcept {
+  return rows_;
+}
+
+template <class T>
+typename MatrixView<T>::i_type MatrixView<T>::GetCols() const noexcept {
+  return cols_;
+}
+
+template <class T>
+const T* MatrixView<T>::GetData() const noexcept {
+  return data_;
+}
+
+template <class T>
+const T& MatrixView<T>::operator()(i_type row, i_type col) const {
+  return data_[row * cols_ + col];
+}
+
+template <class T>
+const T* MatrixView<T>::operator[](i_type row) const {
+  return data_ + row * cols_;
+}
+
+template <class T>
+Matrix<T> MatrixView<T>::ToMatrix() const {
+  Matrix<T> matrix;
+  matrix.rows_ = rows_;
+  matrix.cols_ = cols_;
+  matrix.data_.assign(data_, data_ + rows_ * cols_);
+  return matrix;
+}
+
+}  // namespace s21
+
+#endif  // A2_SIMPLENAVIGATOR_INCLUDE_COMMON_MATRIX_VIEW_H_
@@ -0,0 +1,85 @@
+#ifndef A2_SIMPLENAVIGATOR_INCLUDE_COMMON_PERF_COUNTERS_H_
+#define A2_SIMPLENAVIGATOR_INCLUDE_COMMON_PERF_COUNTERS_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace s21 {
+
+// Per-phase, per-thread event counts read through Linux perf_event_open.
+// Solvers mark their phases with PerfPhase; nothing is counted until Enable()
+// succeeds, and until then a PerfPhase costs one atomic load.
+//
+// Every thread opens its own counter group on its first phase. Task clock is
+// a software event and is always there; the hardware events are skipped
+// individually where the kernel or a virtual machine does not provide them,
+// see IsAvailable(). Counts are exclusive: a nested phase pauses the one
+// around it.
+class PerfCounters {
+ public:
+  enum Event {
+    kTaskClock,
+    kCycles,
+    kInstructions,
+    kCacheMisses,
+    kBranchMisses,
+    kEventCount
+  };
+
+  struct Sample {
+    std::string phase;
+    // Threads are numbered in the order they first entered a phase since the
+    // last Reset().
+    std::size_t thread{};
+    std::uint64_t calls{};
+    std::array<std::uint64_t, kEventCount> values{};
+  };
+
+  // Returns false, leaving counting disabled, if perf_event_open cannot
+  // count even the task clock of the calling thread.
+  static bool Enable();
+  static void Disable() noexcept;
+  [[nodiscard]] static bool IsEnabled() noexcept;
+  [[nodiscard]] static bool IsAvailable(Event event) noexcept;
+  [[nodiscard]] static const char* GetEventName(Event event) noexcept;
+
+  // Drops the counts gathered so far and restarts the thread numbering.
+  static void Reset();
+  [[nodiscard]] static std::vector<Sample> GetSamples();
+
+ private:
+  friend class PerfPhase;
+
+  inline static std::atomic<bool> enabled{false};
+};
+
+class PerfPhase {
+ public:
+  // `name` must outlive the program's use of the counters; phases with equal
+  // names are merged.
+  explicit PerfPhase(const char* name) {
+    if (PerfCounters::enabled.load(std::memory_order_relaxed)) {
+      active_ = Begin(name);
+    }
+  }
+  PerfPhase(const PerfPhase&) = delete;
+  PerfPhase& operator=(const PerfPhase&) = delete;
+  ~PerfPhase() {
+    if (active_) {
+      End();
+    }
+  }
+
+ private:
+  static bool Begin(const char* name);
+  static void End();
+
+  bool active_{};
+};
+
+}  // namespace s21
+
+#endif  // A2_SIMPLENAVIGATOR_INCLUDE_COMMON_PERF_COUNTERS_H_
@@ -0,0 +1,88 @@
+#ifndef A2_SIMPLENAVIGATOR_INCLUDE_COMMON_RANDOM_H_
+#define A2_SIMPLENAVIGATOR_INCLUDE_COMMON_RANDOM_H_
+
+#include <cstdint>
+#include <limits>
+
+namespace s21 {
+
+// xoshiro256++: 32 bytes of state and a few cycles per number, usable with
+// the <random> distributions. The state is filled from the seed by
+// splitmix64; Jump() advances it by 2^128 steps, so the generators obtained
+// from one seed by repeated jumps yield non-overlapping streams.
+class Xoshiro256 {
+ public:
+  using result_type = std::uint64_t;
+
+  explicit Xoshiro256(result_type seed = 0) noexcept;
+
+  static constexpr result_type min() noexcept { return 0; }
+  static constexpr result_type max() noexcept {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() noexcept;
+  // Uniform in [0, 1), from the upper 53 bits.
+  double NextDouble() noexcept;
+  void Jump() noexcept;
+
+ private:
+  static result_type Rotl(result_type x, int k) noexcept;
+
+  result_type s_[4]{};
+};
+
+inline Xoshiro256::Xoshiro256(result_type seed) noexcept {
+  for (auto& word : s_) {
+    seed += 0x9e3779b97f4a7c15;
+    result_type z = seed;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    word = z ^ (z >> 31);
+  }
+}
+
+inline Xoshiro256::result_type Xoshiro256::operator()() noexcept {
+  result_type result = Rotl(s_[0] + s_[3], 23) + s_[0];
+  result_type t = s_[1] << 17;
+  s_[2] ^= s_[0];
+  s_[3] ^= s_[1];
+  s_[1] ^= s_[2];
+  s_[0] ^= s_[3];
+  s_[2] ^= t;
+  s_[3] = Rotl(s_[3], 45);
+  return result;
+}
+
+inline double Xoshiro256::NextDouble() noexcept {
+  return double((*this)() >> 11) * 0x1.0p-53;
+}
+
+inline void Xoshiro256::Jump() noexcept {
+  static constexpr result_type kJump[] = {
+      0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa,
+      0x39abdc4529b1661c};
+  result_type s[4] = {};
+  for (result_type word : kJump) {
+    for (int bit = 0; bit < 64; ++bit) {
+      if (word & (result_type(1) << bit)) {
+        for (int i = 0; i < 4; ++i) {
+          s[i] ^= s_[i];
+        }
+      }
+      (*this)();
+    }
+  }
+  for (int i = 0; i < 4; ++i) {
+    s_[i] = s[i];
+  }
+}
+
+inline Xoshiro256::result_type Xoshiro256::Rotl(result_type x,
+                                                int k) noexcept {
+  return (x << k) | (x >> (64 - k));
+}
+
+}  // namespace s21
+
+#endif  // A2_SIMPLENAVIGATOR_INCLUDE_COMMON_RANDOM_H_
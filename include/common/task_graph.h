@@ -0,0 +1,57 @@
+#ifndef A2_SIMPLENAVIGATOR_INCLUDE_COMMON_TASK_GRAPH_H_
+#define A2_SIMPLENAVIGATOR_INCLUDE_COMMON_TASK_GRAPH_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/thread_pool.h"
+
+namespace s21 {
+
+// Directed acyclic graph of tasks run on a ThreadPool. A task is submitted as
+// soon as the last of its dependencies has finished, so independent branches
+// run concurrently without any task blocking a worker. Run() waits for the
+// whole graph; called from a worker of the same pool, it keeps running tasks
+// until the graph is done, so graphs may be run from tasks. If a task throws,
+// the tasks not yet started are skipped and Run() rethrows the first
+// exception.
+class TaskGraph {
+ public:
+  using Node = std::size_t;
+
+  Node AddTask(std::function<void()> task);
+  void AddDependency(Node before, Node after);
+  void Run(ThreadPool& pool);
+
+  [[nodiscard]] std::size_t GetTaskCount() const noexcept;
+
+ private:
+  struct Vertex {
+    std::function<void()> task;
+    std::vector<Node> successors;
+    std::size_t dependencies{};
+    std::atomic<std::size_t> remaining{};
+  };
+
+  void Schedule(ThreadPool& pool, Node node);
+  void Execute(ThreadPool& pool, Node node);
+  void Finish(ThreadPool& pool, Node node);
+
+  std::vector<std::unique_ptr<Vertex>> vertices_;
+  std::atomic<std::size_t> unfinished_{};
+  std::atomic<bool> failed_{false};
+  // Run() is waiting in ThreadPool::Help() rather than on cv_.
+  bool helped_{};
+  std::exception_ptr exception_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+};
+
+}  // namespace s21
+
+#endif  // A2_SIMPLENAVIGATOR_INCLUDE_COMMON_TASK_GRAPH_H_
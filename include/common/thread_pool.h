@@ -1,20 +1,109 @@
 #ifndef A2_SIMPLENAVIGATOR_INCLUDE_COMMON_THREAD_POOL_H_
 #define A2_SIMPLENAVIGATOR_INCLUDE_COMMON_THREAD_POOL_H_
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <deque>
+#include <exception>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
+#include <ostream>
 #include <thread>
 #include <vector>
 
+#include "common/work_stealing_deque.h"
+
 namespace s21 {
 
+// Work-stealing pool. Tasks added from a worker go to that worker's own
+// deque; tasks added from any other thread are spread round-robin over the
+// workers' inboxes. An idle worker takes from its deque, then its inbox, then
+// steals from the others, and only parks on the condition variable when no
+// task is pending anywhere.
+//
+// Shared() is a process-wide pool with one warm thread per hardware thread.
+// Solvers default to it so repeated calls do not pay for thread start-up;
+// since other callers may be using it at the same time, wait on the futures of
+// your own tasks rather than on Join().
+//
+// AddTask() pays for a packaged_task and a future per call. Loops should use
+// ParallelFor(), which submits at most one task per worker and no futures,
+// and other batches AddTasks().
+//
+// Workers float freely unless a Placement pins them: kCompact fills the CPUs
+// of one NUMA node before the next, kScatter deals workers round-robin over
+// the nodes, and kExplicit pins worker i to cpus[i % cpus.size()]. Only the
+// CPUs the process may run on are used. A kStaticPinned ParallelFor() called
+// from outside the pool runs part i on worker i: the parts go to per-worker
+// queues that are never stolen from, so loops over the same range, such as
+// a first-touch initialization (see Matrix) and the computation that
+// follows, touch each block from the same worker. The price is that such a
+// loop waits for the busiest of its workers.
+//
+// Built with -DS21_THREAD_POOL_STATS (make POOL_STATS=1), the pool also counts
+// per worker, times queueing, running and parking, and can record a trace;
+// otherwise none of it is compiled in and GetStats() reports enabled == false.
 class ThreadPool {
  public:
-  ThreadPool(std::size_t num_of_threads);
+#ifdef S21_THREAD_POOL_STATS
+  static constexpr bool kStatsEnabled = true;
+#else
+  static constexpr bool kStatsEnabled = false;
+#endif
+  static constexpr std::size_t kHistogramBuckets = 32;
+
+  // How ParallelFor() splits a range. kStatic gives every participant one
+  // contiguous block; kDynamic hands out grain-sized chunks on demand;
+  // kGuided hands out chunks shrinking from remaining / (2 * participants)
+  // down to grain. kStaticPinned splits like kStatic, but called from outside
+  // the pool it runs part i on worker i and none on the caller; nested in a
+  // task it is kStatic.
+  enum class Schedule { kStatic, kDynamic, kGuided, kStaticPinned };
+
+  enum class Affinity { kNone, kCompact, kScatter, kExplicit };
+
+  struct Placement {
+    Affinity affinity{Affinity::kNone};
+    // kExplicit only.
+    std::vector<unsigned> cpus;
+  };
+
+  struct WorkerStats {
+    std::uint64_t tasks{};
+    // Tasks taken from another worker's deque or inbox.
+    std::uint64_t steals{};
+    // Parked in cv.wait.
+    std::uint64_t wait_ns{};
+    std::uint64_t busy_ns{};
+    // Enqueue-to-start time, summed over the worker's tasks.
+    std::uint64_t latency_ns{};
+  };
+
+  struct Stats {
+    bool enabled{};
+    std::vector<WorkerStats> workers;
+    // Bucket i counts the times in [2^i, 2^(i + 1)) ns, bucket 0 also 0 ns.
+    std::array<std::uint64_t, kHistogramBuckets> latency_histogram{};
+    std::array<std::uint64_t, kHistogramBuckets> run_time_histogram{};
+    // Locks of the pool's mutexes, those that found the mutex held, and the
+    // time spent waiting for them.
+    std::uint64_t lock_acquisitions{};
+    std::uint64_t lock_contentions{};
+    std::uint64_t lock_wait_ns{};
+  };
+
+  explicit ThreadPool(std::size_t num_of_threads);
+  ThreadPool(std::size_t num_of_threads, const Placement& placement);
   ~ThreadPool();
 
+  static ThreadPool& Shared();
+
   template <class Function, class... Args>
   auto AddTask(Function&& f, Args&&... args)
       -> std::future<decltype(f(args...))> {
@@ -23,33 +112,246 @@ class ThreadPool {
         std::bind(std::forward<Function>(f), std::forward<Args>(args)...));
     std::future<return_type> result = task->get_future();
 
-    {
-      std::lock_guard<std::mutex> lock(mtx);
-
-      if (stop) {
-        throw std::runtime_error("AddTask on stopped ThreadPool");
-      }
-
-      tasks.emplace_back([task]() { (*task)(); });
-      ++task_count;
-    }
-
-    cv.notify_one();
+    Submit(new Task{[task]() { (*task)(); }});
     return result;
   }
 
+  // Runs function(i) for every i in [0, count) as separate tasks, with one
+  // lock per inbox for the whole batch and no futures. Waiting for them is
+  // up to the caller, and function must not throw. It is copied into every
+  // task, so it should capture by reference.
+  template <class Function>
+  void AddTasks(std::size_t count, Function function);
+
+  // Calls function(first, last) on disjoint subranges covering [begin, end),
+  // none shorter than grain but the last, and returns once all of them have
+  // finished. The calling thread takes part, and if it is a worker of this
+  // pool it keeps running other tasks until the loop is done, so calls may
+  // nest. If function throws, chunks not yet started are skipped and the
+  // first exception is rethrown.
+  template <class Function>
+  void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                   Function&& function, Schedule schedule = Schedule::kStatic);
+
   void Join();
+  [[nodiscard]] std::size_t GetThreadCount() const noexcept;
+  // The CPU worker `index` is pinned to, or -1.
+  [[nodiscard]] int GetWorkerCpu(std::size_t index) const noexcept;
+  // The index of the calling thread among this pool's workers, or -1.
+  [[nodiscard]] int GetCurrentWorker() const noexcept;
+
+  // The counters are read while the workers run, so a snapshot taken during
+  // a burst of tasks need not add up exactly.
+  [[nodiscard]] Stats GetStats() const;
+  void ResetStats();
+  // While tracing is on, every task run and every cv.wait is recorded, up to
+  // kMaxTraceEvents per worker. WriteTrace() writes them as Chrome trace_event
+  // JSON, for chrome://tracing or Perfetto.
+  void SetTracing(bool enabled);
+  void WriteTrace(std::ostream& os) const;
 
  private:
-  std::vector<std::thread> threads;
-  std::deque<std::function<void()>> tasks;
+  // Helps from a worker while it waits for a graph, like ParallelFor().
+  friend class TaskGraph;
+
+  using clock = std::chrono::steady_clock;
+
+  struct Task {
+    std::function<void()> function;
+    // Deleted after running; ParallelFor() keeps its tasks on its own stack.
+    bool owned{true};
+#ifdef S21_THREAD_POOL_STATS
+    std::uint64_t enqueued_ns{};
+#endif
+  };
+
+#ifdef S21_THREAD_POOL_STATS
+  static constexpr std::size_t kMaxTraceEvents = 1 << 16;
+
+  struct TraceEvent {
+    const char* name;
+    std::uint64_t begin_ns;
+    std::uint64_t duration_ns;
+  };
+
+  // Written by the owning worker only.
+  struct Counters {
+    std::atomic<std::uint64_t> tasks{};
+    std::atomic<std::uint64_t> steals{};
+    std::atomic<std::uint64_t> wait_ns{};
+    std::atomic<std::uint64_t> busy_ns{};
+    std::atomic<std::uint64_t> latency_ns{};
+    std::array<std::atomic<std::uint64_t>, kHistogramBuckets>
+        latency_histogram{};
+    std::array<std::atomic<std::uint64_t>, kHistogramBuckets>
+        run_time_histogram{};
+    mutable std::mutex trace_mtx;
+    std::vector<TraceEvent> trace;
+  };
+#endif
+
+  struct Worker {
+    WorkStealingDeque<Task*> deque;
+    std::mutex inbox_mtx;
+    std::deque<Task*> inbox;
+    std::atomic<std::size_t> inbox_size{};
+    // Parts of static loops bound to this worker; guarded by inbox_mtx.
+    std::deque<Task*> pinned;
+    std::atomic<std::size_t> pinned_size{};
+    std::thread thread;
+    int cpu{-1};
+#ifdef S21_THREAD_POOL_STATS
+    Counters counters;
+#endif
+  };
+
+  // The progress of one ParallelFor() call.
+  struct Loop {
+    std::atomic<std::size_t> next{};
+    std::atomic<std::size_t> unfinished{};
+    std::atomic<bool> failed{false};
+    // Waited for by a worker, which parks on the pool's cv rather than on
+    // this one.
+    bool helped{};
+    std::exception_ptr exception;
+    std::mutex mtx;
+    std::condition_variable cv;
+  };
+
+  void Submit(Task* task);
+  void Submit(Task* const* tasks, std::size_t count);
+  // Task i runs on worker i; count must not exceed the number of workers.
+  void SubmitPinned(Task* const* tasks, std::size_t count);
+  static void Fail(Loop& loop);
+  void Finish(Loop& loop);
+  void Wait(Loop& loop);
+  // Runs tasks on the calling worker until done() holds, parking like an
+  // idle worker in between. Whoever makes done() hold calls Wake().
+  void Help(const std::function<bool()>& done);
+  void Wake();
+  void Run(std::size_t index);
+  Task* FindTask(std::size_t index);
+  Task* TakeFromInbox(Worker& worker);
+  Task* TakePinned(Worker& worker);
+  void Execute(Task* task, std::size_t index);
+  std::unique_lock<std::mutex> Lock(std::mutex& mutex);
+#ifdef S21_THREAD_POOL_STATS
+  [[nodiscard]] std::uint64_t Now() const noexcept;
+  void Record(Worker& worker, const char* name, std::uint64_t begin_ns,
+              std::uint64_t end_ns);
+#endif
+
+  inline static thread_local ThreadPool* current_pool = nullptr;
+  inline static thread_local std::size_t current_index = 0;
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::atomic<std::size_t> next_inbox{};
+  std::atomic<std::size_t> pending{};
+  std::atomic<std::size_t> unfinished{};
+  std::atomic<std::size_t> sleepers{};
   std::mutex mtx;
   std::condition_variable cv;
   std::condition_variable cv_join;
-  unsigned task_count{};
-  bool stop = false;
+  std::atomic<bool> stop{false};
+#ifdef S21_THREAD_POOL_STATS
+  clock::time_point epoch{clock::now()};
+  std::atomic<bool> tracing{false};
+  std::atomic<std::uint64_t> lock_acquisitions{};
+  std::atomic<std::uint64_t> lock_contentions{};
+  std::atomic<std::uint64_t> lock_wait_ns{};
+#endif
 };
 
+template <class Function>
+void ThreadPool::AddTasks(std::size_t count, Function function) {
+  std::vector<Task*> tasks(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    tasks[i] = new Task{[function, i] { function(i); }};
+  }
+  Submit(tasks.data(), count);
+}
+
+template <class Function>
+void ThreadPool::ParallelFor(std::size_t begin, std::size_t end,
+                             std::size_t grain, Function&& function,
+                             Schedule schedule) {
+  if (begin >= end) {
+    return;
+  }
+  grain = std::max<std::size_t>(grain, 1);
+  std::size_t size = end - begin;
+  std::size_t parts =
+      std::max<std::size_t>(std::min(workers.size(), size / grain), 1);
+  // Only a pinned loop from outside keeps every part on its own worker.
+  bool caller_runs =
+      schedule != Schedule::kStaticPinned || current_pool == this;
+  if (parts == 1 && caller_runs) {
+    function(begin, end);
+    return;
+  }
+
+  std::size_t first_task = caller_runs ? 1 : 0;
+  Loop loop;
+  loop.next = begin;
+  loop.unfinished = parts - first_task;
+  loop.helped = current_pool == this;
+  auto claim = [&loop, end, grain, parts, schedule](std::size_t& first,
+                                                    std::size_t& last) {
+    first = loop.next.load(std::memory_order_relaxed);
+    do {
+      if (first >= end) {
+        return false;
+      }
+      std::size_t chunk = grain;
+      if (schedule == Schedule::kGuided) {
+        chunk = std::max(grain, (end - first) / (2 * parts));
+      }
+      last = first + std::min(chunk, end - first);
+    } while (!loop.next.compare_exchange_weak(first, last));
+    return true;
+  };
+  auto body = [&](std::size_t part) {
+    try {
+      if (schedule == Schedule::kStatic ||
+          schedule == Schedule::kStaticPinned) {
+        if (!loop.failed.load(std::memory_order_relaxed)) {
+          function(begin + size * part / parts,
+                   begin + size * (part + 1) / parts);
+        }
+      } else {
+        std::size_t first = 0;
+        std::size_t last = 0;
+        while (!loop.failed && claim(first, last)) {
+          function(first, last);
+        }
+      }
+    } catch (...) {
+      Fail(loop);
+    }
+    if (part >= first_task) {
+      Finish(loop);
+    }
+  };
+
+  std::vector<Task> tasks;
+  std::vector<Task*> pointers;
+  tasks.reserve(parts - first_task);
+  for (std::size_t part = first_task; part < parts; ++part) {
+    tasks.push_back(Task{[&body, part] { body(part); }, false});
+    pointers.push_back(&tasks.back());
+  }
+  if (caller_runs) {
+    Submit(pointers.data(), pointers.size());
+    body(0);
+  } else {
+    SubmitPinned(pointers.data(), pointers.size());
+  }
+  Wait(loop);
+  if (loop.exception) {
+    std::rethrow_exception(loop.exception);
+  }
+}
+
 }  // namespace s21
 
 #endif  // A2_SIMPLENAVIGATOR_INCLUDE_COMMON_THREAD_POOL_H_
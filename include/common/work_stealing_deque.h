@@ -0,0 +1,136 @@
+#ifndef A2_SIMPLENAVIGATOR_INCLUDE_COMMON_WORK_STEALING_DEQUE_H_
+#define A2_SIMPLENAVIGATOR_INCLUDE_COMMON_WORK_STEALING_DEQUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace s21 {
+
+// Chase-Lev deque (Le, Pop, Cohen, Zappa Nardelli, PPoPP 2013). The owning
+// thread pushes and pops at the bottom, any other thread may steal from the
+// top. Outgrown buffers are kept until destruction because a thief may still
+// be reading from them.
+template <class T>
+class WorkStealingDeque {
+ public:
+  explicit WorkStealingDeque(std::int64_t capacity = 64);
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  void Push(T item);
+  bool Pop(T& item);
+  bool Steal(T& item);
+  [[nodiscard]] bool Empty() const noexcept;
+
+ private:
+  struct Buffer {
+    explicit Buffer(std::int64_t capacity)
+        : capacity(capacity), items(new std::atomic<T>[capacity]) {}
+
+    T Get(std::int64_t i) const {
+      return items[i & (capacity - 1)].load(std::memory_order_relaxed);
+    }
+    void Put(std::int64_t i, T item) {
+      items[i & (capacity - 1)].store(item, std::memory_order_relaxed);
+    }
+
+    std::int64_t capacity;
+    std::unique_ptr<std::atomic<T>[]> items;
+  };
+
+  Buffer* Grow(Buffer* buffer, std::int64_t bottom, std::int64_t top);
+
+  std::atomic<std::int64_t> top_{0};
+  std::atomic<std::int64_t> bottom_{0};
+  std::atomic<Buffer*> buffer_;
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+};
+
+template <class T>
+WorkStealingDeque<T>::WorkStealingDeque(std::int64_t capacity) {
+  if (capacity <= 0 || (capacity & (capacity - 1)) != 0) {
+    throw std::invalid_argument("The capacity must be a power of two");
+  }
+  buffers_.push_back(std::make_unique<Buffer>(capacity));
+  buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+}
+
+template <class T>
+void WorkStealingDeque<T>::Push(T item) {
+  std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+  std::int64_t top = top_.load(std::memory_order_acquire);
+  Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+
+  if (bottom - top > buffer->capacity - 1) {
+    buffer = Grow(buffer, bottom, top);
+  }
+  buffer->Put(bottom, item);
+  std::atomic_thread_fence(std::memory_order_release);
+  bottom_.store(bottom + 1, std::memory_order_relaxed);
+}
+
+template <class T>
+bool WorkStealingDeque<T>::Pop(T& item) {
+  std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+  bottom_.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::int64_t top = top_.load(std::memory_order_relaxed);
+
+  if (top > bottom) {
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return false;
+  }
+
+  item = buffer->Get(bottom);
+  if (top == bottom) {
+    bool won = top_.compare_exchange_strong(
+        top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return won;
+  }
+
+  return true;
+}
+
+template <class T>
+bool WorkStealingDeque<T>::Steal(T& item) {
+  std::int64_t top = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+  if (top >= bottom) {
+    return false;
+  }
+
+  item = buffer_.load(std::memory_order_acquire)->Get(top);
+  return top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed);
+}
+
+template <class T>
+bool WorkStealingDeque<T>::Empty() const noexcept {
+  return bottom_.load(std::memory_order_relaxed) <=
+         top_.load(std::memory_order_relaxed);
+}
+
+template <class T>
+typename WorkStealingDeque<T>::Buffer* WorkStealingDeque<T>::Grow(
+    Buffer* buffer, std::int64_t bottom, std::int64_t top) {
+  auto grown = std::make_unique<Buffer>(buffer->capacity * 2);
+
+  for (std::int64_t i = top; i < bottom; ++i) {
+    grown->Put(i, buffer->Get(i));
+  }
+  buffers_.push_back(std::move(grown));
+  buffer_.store(buffers_.back().get(), std::memory_order_release);
+
+  return buffers_.back().get();
+}
+
+}  // namespace s21
+
+#endif  // A2_SIMPLENAVIGATOR_INCLUDE_COMMON_WORK_STEALING_DEQUE_H_
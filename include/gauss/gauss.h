@@ -1,15 +1,12 @@
 #ifndef A2_SIMPLENAVIGATOR_INCLUDE_GAUSS_GAUSS_H_
 #define A2_SIMPLENAVIGATOR_INCLUDE_GAUSS_GAUSS_H_
 
-#include <condition_variable>
 #include <iostream>
-#include <mutex>
-#include <shared_mutex>
-#include <thread>
 #include <vector>
 
 #include "common/matrix.h"
 #include "common/thread_pool.h"
+#include "gauss/lu_factorization.h"
 
 namespace s21 {
 
@@ -30,31 +27,39 @@ class Gauss {
   bool CheckMatrix();
 };
 
+// Square systems are solved through LuFactorization; systems that are not
+// square or turn out to be singular are handed to Gauss, which tells "no
+// solution" from "infinitely many solutions".
+class BlockedGauss {
+ public:
+  BlockedGauss() = default;
+  BlockedGauss(const Matrix<double>& A, const std::vector<double>& B);
+  ~BlockedGauss() = default;
+  void LoadData(const Matrix<double>& A, const std::vector<double>& B);
+  std::vector<double> Solve();
+
+ private:
+  Matrix<double> A_;
+  std::vector<double> B_;
+  LuFactorization lu_;
+};
+
+// LuFactorization run as a task DAG on the pool, so the trailing updates of
+// different block columns proceed in parallel. Falls back to Gauss in the same
+// cases as BlockedGauss. Solve() waits until the DAG has run; called from a
+// task of the same pool, Shared() by default, it helps run the DAG meanwhile.
 class ParallelGauss {
  public:
   ParallelGauss() = default;
   ParallelGauss(const Matrix<double>& A, const std::vector<double>& B);
   ~ParallelGauss() = default;
   void LoadData(const Matrix<double>& A, const std::vector<double>& B);
-  std::vector<double> Solve();
-  void SubtractingLines();
-  void ReverseMotion();
+  std::vector<double> Solve(ThreadPool& pool = ThreadPool::Shared());
 
  private:
-  void Clear();
-  bool CheckMatrix();
-
- private:
-  std::vector<std::mutex> row_mutex_;
-  std::vector<std::condition_variable> row_cv_;
-  std::vector<std::condition_variable> row_cv_internal_;
-  std::vector<bool> row_ready_;
-  int size_;
   Matrix<double> A_;
   std::vector<double> B_;
-  std::vector<double> X_;
-  std::unique_ptr<ThreadPool> pool_;
-  unsigned rank_decrement{};
+  LuFactorization lu_;
 };
 
 }  // namespace s21
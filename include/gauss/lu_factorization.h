@@ -0,0 +1,77 @@
+#ifndef A2_SIMPLENAVIGATOR_INCLUDE_GAUSS_LU_FACTORIZATION_H_
+#define A2_SIMPLENAVIGATOR_INCLUDE_GAUSS_LU_FACTORIZATION_H_
+
+#include <vector>
+
+#include "common/matrix.h"
+#include "common/thread_pool.h"
+
+namespace s21 {
+
+// PA = LU of a square matrix with partial pivoting, kept so that the same
+// system can be solved against any number of right-hand sides in O(n^2) each.
+// The factorization is right-looking and blocked by kBlockSize columns. Step
+// k eliminates panel k column by column; then every block column j to its
+// right gets the panel's row swaps, a triangular solve for its block of U and
+// a tiled rank-kBlockSize update of the rows below. The threaded overload runs
+// these as a task DAG: panel k waits only for the update of block column k by
+// step k - 1, and the updates of different block columns run in parallel.
+// The pool overloads wait until their DAG has run, and may be called from a
+// task of the same pool.
+//
+// L (unit diagonal, below) and U (on and above the diagonal) share LU_;
+// pivots_[i] is the row swapped with row i at step i.
+class LuFactorization {
+ public:
+  static constexpr std::size_t kBlockSize = 64;
+  static constexpr std::size_t kSolveBlockSize = 256;
+  static constexpr std::size_t kMr = 4;
+  static constexpr std::size_t kNr = 4;
+
+  LuFactorization() = default;
+  explicit LuFactorization(const Matrix<double>& A);
+
+  // Returns false and leaves the object empty if A is singular.
+  bool Factorize(const Matrix<double>& A);
+  bool Factorize(const Matrix<double>& A, ThreadPool& pool);
+  [[nodiscard]] bool IsFactorized() const noexcept;
+  [[nodiscard]] std::size_t GetSize() const noexcept;
+
+  [[nodiscard]] std::vector<double> Solve(const std::vector<double>& b) const;
+  // Blocked triangular solves as a task DAG: once a diagonal block of the
+  // solution is final, the updates of every other pending block by it run in
+  // parallel.
+  [[nodiscard]] std::vector<double> Solve(const std::vector<double>& b,
+                                          ThreadPool& pool) const;
+  // Every column of B is a right-hand side; column j of the result solves it.
+  [[nodiscard]] Matrix<double> Solve(const Matrix<double>& B) const;
+
+ private:
+  void Reset(const Matrix<double>& A);
+  void Clear();
+  [[nodiscard]] std::size_t GetBlockCount() const noexcept;
+  [[nodiscard]] std::size_t GetBlockWidth(std::size_t block) const noexcept;
+  bool FactorizePanel(std::size_t block);
+  void UpdateBlockColumn(std::size_t step, std::size_t block);
+  void SwapLeftColumns(std::size_t block);
+  void ReleasePanel(std::size_t block);
+  void CheckRightHandSide(std::size_t rows) const;
+  void SolveDiagonalBlock(bool upper, std::size_t block,
+                          std::vector<double>& X) const;
+  void UpdateSolutionBlock(std::size_t solved, std::size_t block,
+                           std::vector<double>& X) const;
+
+  using Tile = double[kMr][kNr];
+  static void MicroKernel(std::size_t depth, const double* l, const double* u,
+                          Tile& c);
+
+  Matrix<double> LU_;
+  std::vector<std::size_t> pivots_;
+  // L below the diagonal block of each panel, packed in kMr-row blocks, and
+  // released after the last trailing update of its step.
+  std::vector<std::vector<double>> packed_l_;
+};
+
+}  // namespace s21
+
+#endif  // A2_SIMPLENAVIGATOR_INCLUDE_GAUSS_LU_FACTORIZATION_H_
@@ -1,65 +1,67 @@
 #ifndef A2_SIMPLENAVIGATOR_INCLUDE_GRAPE_GRAPE_H_
 #define A2_SIMPLENAVIGATOR_INCLUDE_GRAPE_GRAPE_H_
 
-#include <atomic>
-
 #include "common/matrix.h"
+#include "common/matrix_view.h"
 #include "common/thread_pool.h"
 
 namespace s21 {
 
+// The solvers only read their inputs: a Matrix is copied once into a view
+// of its own, and a mapped MatrixView is multiplied in place.
 class Grape {
  public:
   Grape() = default;
   Grape(const Matrix<double>& m1, const Matrix<double>& m2);
+  Grape(const MatrixView<double>& m1, const MatrixView<double>& m2);
   ~Grape() = default;
   void LoadMatrices(const Matrix<double>& m1, const Matrix<double>& m2);
+  void LoadMatrices(const MatrixView<double>& m1, const MatrixView<double>& m2);
   Matrix<double> Mul();
 
  private:
-  Matrix<double> m1_;
-  Matrix<double> m2_;
+  MatrixView<double> m1_;
+  MatrixView<double> m2_;
 };
 
 class ClassicParallelGrape {
  public:
   ClassicParallelGrape() = default;
   ClassicParallelGrape(const Matrix<double>& m1, const Matrix<double>& m2);
+  ClassicParallelGrape(const MatrixView<double>& m1,
+                       const MatrixView<double>& m2);
   ~ClassicParallelGrape() = default;
   void LoadMatrices(const Matrix<double>& m1, const Matrix<double>& m2);
-  Matrix<std::atomic<double>>& Mul(std::size_t number_of_threads);
+  void LoadMatrices(const MatrixView<double>& m1, const MatrixView<double>& m2);
+  Matrix<double> Mul(std::size_t number_of_threads);
+  Matrix<double> Mul(ThreadPool& pool = ThreadPool::Shared());
 
  private:
-  Matrix<std::atomic<double>> m1_;
-  Matrix<std::atomic<double>> m2_;
-  Matrix<std::atomic<double>> X_;
-  std::vector<std::atomic<double>> row_factor_;
-  std::vector<std::atomic<double>> column_factor_;
+  MatrixView<double> m1_;
+  MatrixView<double> m2_;
 };
 
 class PipelineParallelGrape {
  public:
   PipelineParallelGrape() = default;
   PipelineParallelGrape(const Matrix<double>& m1, const Matrix<double>& m2);
+  PipelineParallelGrape(const MatrixView<double>& m1,
+                        const MatrixView<double>& m2);
   void LoadMatrices(const Matrix<double>& m1, const Matrix<double>& m2);
-  Matrix<std::atomic<double>>& Mul(std::size_t number_of_threads);
+  void LoadMatrices(const MatrixView<double>& m1, const MatrixView<double>& m2);
+  Matrix<double> Mul(std::size_t number_of_threads);
+  Matrix<double> Mul(ThreadPool& pool = ThreadPool::Shared());
 
  private:
-  double CalculateRowFactor(std::size_t row);
-  void TryCalculateColumnFactor(std::size_t column);
-  void CalculateOneMatrixElement(std::size_t row, std::size_t column,
-                                 const double& row_factor);
-  void TryCalculateOddMatrix(std::size_t row, std::size_t column);
+  double CalculateRowFactor(std::size_t row) const;
+  double CalculateColumnFactor(std::size_t column) const;
+  double CalculateOneMatrixElement(std::size_t row, std::size_t column,
+                                   double row_factor,
+                                   double column_factor) const;
 
  private:
-  std::condition_variable cv;
-  std::mutex mtx;
-  std::vector<bool> col_factor_flag;
-  Matrix<std::atomic<double>> m1_;
-  Matrix<std::atomic<double>> m2_;
-  Matrix<std::atomic<double>> X_;
-  std::vector<std::atomic<double>> row_factor_;
-  std::vector<std::atomic<double>> column_factor_;
+  MatrixView<double> m1_;
+  MatrixView<double> m2_;
 };
 
 }  // namespace s21
@@ -0,0 +1,49 @@
+#ifndef A2_SIMPLENAVIGATOR_INCLUDE_GRAPE_WINOGRAD_KERNEL_H_
+#define A2_SIMPLENAVIGATOR_INCLUDE_GRAPE_WINOGRAD_KERNEL_H_
+
+#include <vector>
+
+#include "common/matrix.h"
+#include "common/matrix_view.h"
+
+namespace s21 {
+
+// Cache-blocked Winograd product. The second matrix is packed once into
+// column panels of kNr columns, each storing the (2k + 1, 2k) row pairs
+// contiguously; rows of the first matrix are packed per kMc x kKc block and
+// multiplied by a kMr x kNr register tile. Every result element accumulates
+// its terms in the same order as the naive triple loop, so results are
+// bit-identical to it.
+class WinogradKernel {
+ public:
+  static constexpr std::size_t kMr = 4;
+  static constexpr std::size_t kNr = 4;
+  static constexpr std::size_t kMc = 64;
+  static constexpr std::size_t kKc = 128;
+
+  WinogradKernel(const MatrixView<double>& m1, const MatrixView<double>& m2);
+
+  [[nodiscard]] std::size_t GetPanelCount() const noexcept;
+  void PackPanels(std::size_t panel_begin, std::size_t panel_end);
+  void Compute(std::size_t row_begin, std::size_t row_end,
+               Matrix<double>& result) const;
+
+ private:
+  using Tile = double[kMr][kNr];
+
+  void PackRows(std::size_t row_begin, std::size_t rows, std::size_t pair_begin,
+                std::size_t pairs, double* packed) const;
+  static void MicroKernel(std::size_t pairs, const double* a, const double* b,
+                          Tile& c);
+
+  const MatrixView<double>& m1_;
+  const MatrixView<double>& m2_;
+  std::size_t pairs_;
+  std::size_t panel_stride_;
+  std::vector<double> packed_m2_;
+  std::vector<double> column_factor_;
+};
+
+}  // namespace s21
+
+#endif  // A2_SIMPLENAVIGATOR_INCLUDE_GRAPE_WINOGRAD_KERNEL_H_
@@ -2,11 +2,22 @@
 #define A2_SIMPLENAVIGATOR_INCLUDE_TESTS_TEST_CORE_H_
 
 #include <gtest/gtest.h>
+#include <sched.h>
 
+#include <atomic>
+#include <filesystem>
+#include <numeric>
+#include <set>
+#include <sstream>
 #include <unordered_set>
 
 #include "ant/ant.h"
+#include "common/benchmark.h"
 #include "common/functions.h"
+#include "common/matrix_view.h"
+#include "common/perf_counters.h"
+#include "common/task_graph.h"
+#include "common/thread_pool.h"
 #include "gauss/gauss.h"
 #include "grape/grape.h"
 #include "test_files.h"
@@ -28,6 +39,18 @@ class ANT : public ::testing::Test {
   Ant ant;
 };
 
+class BENCHMARK : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    options.min_iterations = 7;
+    options.max_iterations = 7;
+    options.min_time = std::chrono::nanoseconds(0);
+  }
+  void TearDown() override {}
+
+  Benchmark::Options options;
+};
+
 class GAUSS : public ::testing::Test {
  protected:
   void SetUp() override {}
@@ -36,6 +59,8 @@ class GAUSS : public ::testing::Test {
                       const std::vector<double>& v2);
 
   Gauss gauss;
+  BlockedGauss blocked_gauss;
+  LuFactorization lu;
   ParallelGauss parallel_gauss;
   Matrix<double> matrix;
   std::vector<double> vector;
@@ -55,6 +80,30 @@ class GRAPE : public ::testing::Test {
   Matrix<double> m2;
 };
 
+class MATRIX : public ::testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  // Records the worker of `pool` that constructed it.
+  struct Touch {
+    inline static ThreadPool* pool = nullptr;
+    int worker{pool ? pool->GetCurrentWorker() : -2};
+  };
+
+  Matrix<double> matrix;
+};
+
+class THREAD_POOL : public ::testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+  void SpawnTree(ThreadPool& pool, unsigned depth);
+
+  static constexpr std::size_t kThreads = 4;
+  std::atomic<unsigned> counter{};
+};
+
 }  // namespace Test
 
 #endif  // A2_SIMPLENAVIGATOR_INCLUDE_TESTS_TEST_CORE_H_
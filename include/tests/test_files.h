@@ -8,6 +8,10 @@ struct File {
       "./tests/materials/non_oriented_weighted_matrix_5x5.txt";
   static constexpr const char* kNonOrientedWeightedMatrix10x10 =
       "./tests/materials/non_oriented_weighted_matrix_10x10.txt";
+  static constexpr const char* kTsplibEuc2d5 =
+      "./tests/materials/tsplib_euc_2d_5.tsp";
+  static constexpr const char* kTsplibBurma14 =
+      "./tests/materials/tsplib_burma14.tsp";
   static constexpr const char* kGaussMatrix3x4 =
       "./tests/materials/gauss_matrix_3x4.txt";
   static constexpr const char* kGaussMatrix11x12 =
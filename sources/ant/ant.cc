@@ -1,147 +1,867 @@
 #include "ant/ant.h"
 
-#include <mutex>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <random>
-#include <thread>
+
+#include "common/perf_counters.h"
 
 namespace s21 {
 
-void Ant::LoadGraph(Graph& graph) {
+namespace {
+
+// std::pow without the call for the default exponents, alpha = 1 and
+// beta = 2: choice values computed for every edge and iteration are
+// dominated by it otherwise.
+double Power(double base, double exponent) {
+  if (exponent == 1.0) {
+    return base;
+  } else if (exponent == 2.0) {
+    return base * base;
+  }
+  return std::pow(base, exponent);
+}
+
+}  // namespace
+
+void Ant::LoadGraph(const Graph& graph) {
   if (!graph.IsLoaded()) throw std::runtime_error("graph is not loaded");
   if (!graph.IsComplete()) throw std::runtime_error("Not a complete graph");
   if (!graph.IsWeighted()) throw std::runtime_error("Not a weighted graph");
-  graph_ = graph;
-  number_of_ants = 10;
-  max_iterations = 100;
-}
-
-Ant::tour_t Ant::ConstructTour() {
-  tour_t tour;
-  std::vector<bool> visited(graph_.GetSize(), false);
-  std::random_device rd;
-  std::mt19937 gen(rd());
-
-  std::uniform_int_distribution<size_type> dist(0, graph_.GetSize() - 1);
-  std::uniform_real_distribution<double> real_dist(0.0, 1.0);
-  auto start_city = dist(gen);
-
-  tour.push_back(start_city);
-  visited[start_city] = true;
-
-  for (size_type step = 1; step < graph_.GetSize(); ++step) {
-    auto current_city = tour.back();
-    double total_probability = 0.0;
-    std::vector<double> probabilities(graph_.GetSize(), 0.0);
-
-    for (size_type next_city = 0; next_city < graph_.GetSize(); ++next_city) {
-      if (!visited[next_city]) {
-        auto pheromone = pheromone_mx_[current_city][next_city];
-        auto distance = graph_.GetWeight(current_city, next_city);
-        probabilities[next_city] =
-            pow(pheromone, alpha) * pow(1.0 / double(distance), beta);
-        total_probability += probabilities[next_city];
+  graph_ = &graph;
+  neighbours_ = NeighbourLists();
+  local_search_.reset();
+}
+
+void Ant::SetOptions(const Options& options) {
+  if (options.number_of_ants == 0 || options.max_iterations == 0) {
+    throw std::invalid_argument(
+        "The number of ants and iterations must be positive");
+  } else if (!(options.alpha >= 0.0 && std::isfinite(options.alpha)) ||
+             !(options.beta >= 0.0 && std::isfinite(options.beta))) {
+    throw std::invalid_argument(
+        "The exponents alpha and beta must be finite and non-negative");
+  } else if (!(options.evaporation_rate > 0.0 &&
+               options.evaporation_rate <= 1.0)) {
+    throw std::invalid_argument("The evaporation rate must be in (0, 1]");
+  } else if (!(options.acs_local_evaporation >= 0.0 &&
+               options.acs_local_evaporation <= 1.0)) {
+    throw std::invalid_argument(
+        "The local evaporation rate must be in [0, 1]");
+  } else if (!(options.acs_q0 >= 0.0 && options.acs_q0 <= 1.0)) {
+    throw std::invalid_argument("The probability must be in [0, 1]");
+  } else if (!(options.max_min_p_best > 0.0 && options.max_min_p_best < 1.0)) {
+    throw std::invalid_argument(
+        "The probability of the best tour must be in (0, 1)");
+  } else if (options.rank_size == 0) {
+    throw std::invalid_argument("The rank size must be positive");
+  } else if (options.colonies == 0 || options.migration_interval == 0) {
+    throw std::invalid_argument(
+        "The number of colonies and the migration interval must be positive");
+  } else if (!(options.min_entropy >= 0.0 && options.min_entropy <= 1.0)) {
+    throw std::invalid_argument("The entropy threshold must be in [0, 1]");
+  }
+  options_ = options;
+}
+
+const Ant::Options& Ant::GetOptions() const noexcept { return options_; }
+
+Matrix<double> Ant::GetPheromone(size_type colony) const {
+  if (colony >= colonies_.size()) {
+    throw std::out_of_range("No such colony");
+  }
+  const Colony& trails = colonies_[colony];
+  auto size = graph_->GetSize();
+  Matrix<double> pheromone{size, size, trails.tau_rest};
+  for (size_type i = 0; i < size; ++i) {
+    for (size_type column = 0; column < trails.pheromone_mx.GetCols();
+         ++column) {
+      pheromone(i, ColumnCity(i, column)) = trails.pheromone_mx(i, column);
+    }
+    if (candidates_ > 0) {
+      for (const Trail& trail : trails.off_candidate[i]) {
+        pheromone(i, trail.city) = trail.tau;
       }
     }
+  }
+  return pheromone;
+}
 
-    auto random_probability = real_dist(gen);
-    double cumulative_probability = 0.0;
-    for (size_type next_city = 0; next_city < graph_.GetSize(); ++next_city) {
-      if (!visited[next_city]) {
-        cumulative_probability += probabilities[next_city] / total_probability;
-        if (random_probability <= cumulative_probability) {
-          tour.push_back(next_city);
-          visited[next_city] = true;
-          break;
-        }
+Ant::size_type Ant::ColumnCity(size_type row, size_type column) const {
+  return candidates_ > 0 ? neighbours_.Get(row)[column] : column;
+}
+
+Ant::size_type Ant::FindColumn(size_type from, size_type to) const {
+  if (candidates_ == 0) {
+    return to;
+  }
+  const size_type* neighbours = neighbours_.Get(from);
+  for (size_type column = 0; column < candidates_; ++column) {
+    if (neighbours[column] == to) {
+      return column;
+    }
+  }
+  return size_type_max;
+}
+
+double& Ant::FindTrail(Colony& colony, size_type from, size_type to) {
+  auto column = FindColumn(from, to);
+  if (column != size_type_max) {
+    return colony.pheromone_mx(from, column);
+  }
+  auto& trails = colony.off_candidate[from];
+  for (Trail& trail : trails) {
+    if (trail.city == to) {
+      return trail.tau;
+    }
+  }
+  trails.push_back({to, colony.tau_rest});
+  return trails.back().tau;
+}
+
+double Ant::ComputeHeuristic(size_type from, size_type to) const {
+  return Power(1.0 / double(graph_->GetWeight(from, to)), options_.beta);
+}
+
+void Ant::UpdateChoiceInfo(Colony& colony, size_type row_begin,
+                           size_type row_end) {
+  PerfPhase phase("ant/choice_info");
+  auto columns = colony.choice_info_mx.GetCols();
+  for (size_type i = row_begin; i < row_end; ++i) {
+    const double* pheromone = &colony.pheromone_mx(i, 0);
+    double* choice = &colony.choice_info_mx(i, 0);
+    if (heuristic_mx_.GetRows() == 0) {
+      for (size_type j = 0; j < columns; ++j) {
+        choice[j] = j != i ? Power(pheromone[j], options_.alpha) *
+                                 ComputeHeuristic(i, j)
+                           : 0.0;
       }
+      continue;
+    }
+    const double* heuristic = &heuristic_mx_(i, 0);
+    for (size_type j = 0; j < columns; ++j) {
+      choice[j] = Power(pheromone[j], options_.alpha) * heuristic[j];
     }
   }
+}
+
+void Ant::ConstructTour(const Colony& colony, tour_t& tour,
+                        Xoshiro256& generator) {
+  PerfPhase phase("ant/construct_tour");
+  auto size = graph_->GetSize();
+  std::vector<double> unvisited(size, 1.0);
+  std::vector<double> weights(candidates_ > 0 ? candidates_ : size, 0.0);
 
-  return tour;
+  StartTour(tour, unvisited, generator);
+  for (size_type step = 1; step < size; ++step) {
+    tour[step] = SelectNextCity(colony, tour[step - 1], unvisited, weights,
+                                generator);
+    unvisited[tour[step]] = 0.0;
+  }
 }
 
-void Ant::UpdatePheromone() {
-  for (size_type i = 0; i < graph_.GetSize(); ++i) {
-    for (size_type j = 0; j < graph_.GetSize(); ++j) {
-      pheromone_mx_[i][j] *= (1.0 - evaporation_rate);
+void Ant::ConstructToursTogether(Colony& colony) {
+  // The ants move in turn, each one step at a time, and every move decays
+  // its edge before the next ant chooses.
+  PerfPhase phase("ant/construct_tour");
+  auto size = graph_->GetSize();
+  auto ants = options_.number_of_ants;
+  std::vector<std::vector<double>> unvisited(ants,
+                                             std::vector<double>(size, 1.0));
+  std::vector<double> weights(candidates_ > 0 ? candidates_ : size, 0.0);
+
+  for (size_type ant = 0; ant < ants; ++ant) {
+    StartTour(colony.tours[ant], unvisited[ant], colony.generators[ant]);
+  }
+  for (size_type step = 1; step < size; ++step) {
+    for (size_type ant = 0; ant < ants; ++ant) {
+      tour_t& tour = colony.tours[ant];
+      tour[step] = SelectNextCity(colony, tour[step - 1], unvisited[ant],
+                                  weights, colony.generators[ant]);
+      unvisited[ant][tour[step]] = 0.0;
+      UpdateLocally(colony, tour[step - 1], tour[step]);
     }
   }
+  for (tour_t& tour : colony.tours) {
+    UpdateLocally(colony, tour[size - 1], tour[0]);
+  }
+}
 
-  if (parallel_) {
-    for (size_type i = 0; i < number_of_ants; ++i) {
-      pool_->AddTask([this]() { ProcessPheromoneUpdate(); });
+void Ant::StartTour(tour_t& tour, std::vector<double>& unvisited,
+                    Xoshiro256& generator) {
+  auto size = graph_->GetSize();
+  std::uniform_int_distribution<size_type> dist(0, size - 1);
+  tour.resize(size);
+  tour[0] = dist(generator);
+  unvisited[tour[0]] = 0.0;
+}
+
+Ant::size_type Ant::SelectNextCity(const Colony& colony,
+                                   size_type current_city,
+                                   std::vector<double>& unvisited,
+                                   std::vector<double>& weights,
+                                   Xoshiro256& generator) {
+  auto size = graph_->GetSize();
+  bool exploit = options_.variant == Variant::kAntColonySystem;
+  const double* choice = &colony.choice_info_mx(current_city, 0);
+  size_type next_city = size_type_max;
+  bool greedy = exploit && generator.NextDouble() < options_.acs_q0;
+
+  if (candidates_ > 0) {
+    const size_type* neighbours = neighbours_.Get(current_city);
+    double total_weight = 0.0;
+    for (size_type i = 0; i < candidates_; ++i) {
+      weights[i] = choice[i] * unvisited[neighbours[i]];
+      total_weight += weights[i];
+    }
+    if (total_weight > 0.0 && std::isfinite(total_weight)) {
+      auto index =
+          greedy ? size_type(std::max_element(weights.begin(), weights.end()) -
+                             weights.begin())
+                 : SelectCity(weights, generator.NextDouble() * total_weight);
+      next_city = index == size_type_max ? index : neighbours[index];
     }
-    pool_->Join();
+  } else if (greedy) {
+    next_city = SelectBestCity(choice, unvisited.data(), size);
   } else {
-    for (size_type ant = 0; ant < number_of_ants; ++ant) {
-      ProcessPheromoneUpdate();
+    double total_weight =
+        ComputeWeights(choice, unvisited.data(), weights.data(), size);
+    if (total_weight > 0.0 && std::isfinite(total_weight)) {
+      next_city = SelectCity(weights, generator.NextDouble() * total_weight);
+    }
+  }
+  if (next_city == size_type_max) {
+    next_city = candidates_ > 0
+                    ? SelectFallbackCity(colony, current_city, unvisited)
+                    : SelectBestCity(choice, unvisited.data(), size);
+  }
+  return next_city;
+}
+
+void Ant::UpdateLocally(Colony& colony, size_type from, size_type to) {
+  double xi = options_.acs_local_evaporation;
+  auto column = FindColumn(from, to);
+  double& tau = column == size_type_max ? FindTrail(colony, from, to)
+                                        : colony.pheromone_mx(from, column);
+  tau = (1.0 - xi) * tau + xi * tau0_;
+  if (column != size_type_max) {
+    double heuristic = heuristic_mx_.GetRows() > 0
+                           ? heuristic_mx_(from, column)
+                           : ComputeHeuristic(from, to);
+    colony.choice_info_mx(from, column) =
+        Power(tau, options_.alpha) * heuristic;
+  }
+}
+
+Ant::size_type Ant::SelectFallbackCity(const Colony& colony, size_type city,
+                                       std::vector<double>& unvisited) const {
+  // The best of the candidates, of the edges off the list that have a trail
+  // of their own, and of the nearest other city: the rest share tau_rest,
+  // so none of them can have a higher choice value.
+  const size_type* neighbours = neighbours_.Get(city);
+  const double* choice = &colony.choice_info_mx(city, 0);
+  const auto& trails = colony.off_candidate[city];
+  size_type best = size_type_max;
+  double best_choice = 0.0;
+  auto consider = [&best, &best_choice](size_type other, double value) {
+    if (best == size_type_max || value > best_choice) {
+      best = other;
+      best_choice = value;
+    }
+  };
+  for (size_type i = 0; i < candidates_; ++i) {
+    if (unvisited[neighbours[i]] > 0.0) {
+      consider(neighbours[i], choice[i]);
+      unvisited[neighbours[i]] = -1.0;
+    }
+  }
+  for (const Trail& trail : trails) {
+    if (unvisited[trail.city] > 0.0) {
+      consider(trail.city, Power(trail.tau, options_.alpha) *
+                               ComputeHeuristic(city, trail.city));
+      unvisited[trail.city] = -1.0;
     }
   }
+
+  size_type nearest = size_type_max;
+  Graph::weight_type nearest_weight = 0;
+  for (size_type other = 0; other < unvisited.size(); ++other) {
+    if (unvisited[other] > 0.0) {
+      auto weight = graph_->GetWeight(city, other);
+      if (nearest == size_type_max || weight < nearest_weight) {
+        nearest = other;
+        nearest_weight = weight;
+      }
+    }
+  }
+  if (nearest != size_type_max) {
+    consider(nearest, Power(colony.tau_rest, options_.alpha) *
+                          ComputeHeuristic(city, nearest));
+  }
+
+  // The cities set aside above are still unvisited.
+  for (size_type i = 0; i < candidates_; ++i) {
+    if (unvisited[neighbours[i]] < 0.0) {
+      unvisited[neighbours[i]] = 1.0;
+    }
+  }
+  for (const Trail& trail : trails) {
+    if (unvisited[trail.city] < 0.0) {
+      unvisited[trail.city] = 1.0;
+    }
+  }
+  return best;
 }
 
-void Ant::ProcessPheromoneUpdate() {
-  auto tour = ConstructTour();
-  auto tourDistance = double(CalculateTotalDistance(tour));
+double Ant::ComputeWeights(const double* choice, const double* unvisited,
+                           double* weights, size_type size) {
+  // Visited cities are masked out by multiplication rather than a branch, and
+  // four partial sums keep the loop free of a single serial dependency.
+  double sum[4] = {};
+  size_type i = 0;
+  for (; i + 4 <= size; i += 4) {
+    for (size_type lane = 0; lane < 4; ++lane) {
+      weights[i + lane] = choice[i + lane] * unvisited[i + lane];
+      sum[lane] += weights[i + lane];
+    }
+  }
+  for (; i < size; ++i) {
+    weights[i] = choice[i] * unvisited[i];
+    sum[0] += weights[i];
+  }
+  return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
 
-  auto size = graph_.GetSize();
-  for (size_type i = 0; i < size - 1; ++i) {
-    auto city1 = tour[i];
-    auto city2 = tour[i + 1];
-    AddPheromoneValue(city1, city2, 1.0 / tourDistance);
+Ant::size_type Ant::SelectCity(const std::vector<double>& weights,
+                               double target) {
+  // Skip whole groups of four while they cannot contain the target, then
+  // walk the group that does. If rounding leaves the target past the end,
+  // the last city with a positive weight is returned.
+  auto size = weights.size();
+  double cumulative = 0.0;
+  size_type i = 0;
+
+  for (; i + 4 <= size; i += 4) {
+    double group =
+        (weights[i] + weights[i + 1]) + (weights[i + 2] + weights[i + 3]);
+    if (target <= cumulative + group) {
+      break;
+    }
+    cumulative += group;
   }
-  auto lastCity = tour[size - 1];
-  auto firstCity = tour[0];
-  AddPheromoneValue(lastCity, firstCity, 1.0 / tourDistance);
+  for (; i < size; ++i) {
+    cumulative += weights[i];
+    if (weights[i] > 0.0 && target <= cumulative) {
+      return i;
+    }
+  }
+  for (i = size; i-- > 0;) {
+    if (weights[i] > 0.0) {
+      return i;
+    }
+  }
+  return size_type_max;
+}
+
+Ant::size_type Ant::SelectBestCity(const double* choice,
+                                   const double* unvisited, size_type size) {
+  size_type best = size_type_max;
+  for (size_type i = 0; i < size; ++i) {
+    if (unvisited[i] > 0.0 &&
+        (best == size_type_max || choice[i] > choice[best])) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+template <class Function>
+void Ant::ForEach(size_type count, bool parallel, Function function) {
+  if (!parallel) {
+    for (size_type i = 0; i < count; ++i) {
+      function(i);
+    }
+    return;
+  }
+  pool_->ParallelFor(
+      0, count, 1,
+      [&function](size_type first, size_type last) {
+        for (size_type i = first; i < last; ++i) {
+          function(i);
+        }
+      },
+      ThreadPool::Schedule::kDynamic);
+}
+
+double Ant::RunIteration(Colony& colony, bool parallel) {
+  auto size = graph_->GetSize();
+  size_type chunks = parallel ? std::min(pool_->GetThreadCount(), size) : 1;
+  // One value per row, summed in row order below, so that the entropy and
+  // with it the iteration that stops a seeded run do not depend on chunks.
+  std::vector<double> entropy(options_.min_entropy > 0.0 ? size : 0, 0.0);
+
+  ForEach(chunks, parallel, [this, &colony, size, chunks](size_type chunk) {
+    UpdateChoiceInfo(colony, size * chunk / chunks,
+                     size * (chunk + 1) / chunks);
+  });
+  // Every ant writes only its own tour; the pheromone update is then reduced
+  // by row ranges, each task applying the deposits in a fixed order, so the
+  // result does not depend on scheduling. ACS ants change the trails as they
+  // go and are moved in a fixed order on this thread instead.
+  bool together = options_.variant == Variant::kAntColonySystem;
+  if (together) {
+    ConstructToursTogether(colony);
+  }
+  ForEach(options_.number_of_ants, parallel,
+          [this, &colony, together](size_type ant) {
+            if (!together) {
+              ConstructTour(colony, colony.tours[ant], colony.generators[ant]);
+            }
+            colony.tour_lengths[ant] =
+                CalculateTotalDistance(colony.tours[ant]);
+          });
+  ImproveTours(colony, parallel);
+  UpdateBestTour(colony);
+  PrepareDeposits(colony);
+  ForEach(chunks, parallel,
+          [this, &colony, size, chunks, &entropy](size_type chunk) {
+            size_type row_begin = size * chunk / chunks;
+            size_type row_end = size * (chunk + 1) / chunks;
+            UpdatePheromoneRows(colony, row_begin, row_end);
+            if (options_.min_entropy > 0.0) {
+              for (size_type i = row_begin; i < row_end; ++i) {
+                entropy[i] = CalculateEntropy(colony, i);
+              }
+            }
+          });
+
+  if (options_.min_entropy <= 0.0) {
+    return 1.0;
+  }
+  return std::accumulate(entropy.begin(), entropy.end(), 0.0) / double(size);
+}
+
+void Ant::ImproveTours(Colony& colony, bool parallel) {
+  auto& tours = colony.tours;
+  auto& lengths = colony.tour_lengths;
+  if (options_.local_search == LocalSearchMode::kAllAnts) {
+    ForEach(options_.number_of_ants, parallel,
+            [this, &tours, &lengths](size_type ant) {
+              if (local_search_->Improve(tours[ant])) {
+                lengths[ant] = CalculateTotalDistance(tours[ant]);
+              }
+            });
+  } else if (options_.local_search == LocalSearchMode::kIterationBest) {
+    auto best = std::min_element(lengths.begin(), lengths.end()) -
+                lengths.begin();
+    if (local_search_->Improve(tours[best])) {
+      lengths[best] = CalculateTotalDistance(tours[best]);
+    }
+  }
+}
+
+void Ant::UpdateBestTour(Colony& colony) {
+  for (size_type ant = 0; ant < options_.number_of_ants; ++ant) {
+    if (colony.tour_lengths[ant] < colony.best_tour_distance) {
+      colony.best_tour = colony.tours[ant];
+      colony.best_tour_distance = colony.tour_lengths[ant];
+    }
+  }
+}
+
+void Ant::PrepareDeposits(Colony& colony) {
+  PerfPhase phase("ant/pheromone_update");
+  const auto& tours = colony.tours;
+  const auto& lengths = colony.tour_lengths;
+  auto& deposits = colony.deposits;
+  double rho = options_.evaporation_rate;
+  double best_amount = 1.0 / double(colony.best_tour_distance);
+  deposits.clear();
+  colony.keep = 1.0 - rho;
+
+  switch (options_.variant) {
+    case Variant::kAntSystem:
+    case Variant::kElitist:
+      for (size_type ant = 0; ant < options_.number_of_ants; ++ant) {
+        deposits.push_back({&tours[ant], 1.0, 1.0 / double(lengths[ant])});
+      }
+      if (options_.variant == Variant::kElitist) {
+        deposits.push_back(
+            {&colony.best_tour, 1.0, options_.elite_weight * best_amount});
+      }
+      break;
+    case Variant::kRankBased: {
+      std::vector<size_type> order(options_.number_of_ants);
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(),
+                       [&lengths](size_type a, size_type b) {
+                         return lengths[a] < lengths[b];
+                       });
+      auto ranked = std::min(options_.rank_size - 1, order.size());
+      for (size_type rank = 0; rank < ranked; ++rank) {
+        double weight = double(options_.rank_size - 1 - rank);
+        deposits.push_back({&tours[order[rank]], 1.0,
+                            weight / double(lengths[order[rank]])});
+      }
+      deposits.push_back(
+          {&colony.best_tour, 1.0, double(options_.rank_size) * best_amount});
+      break;
+    }
+    case Variant::kMaxMin: {
+      auto best = std::min_element(lengths.begin(), lengths.end()) -
+                  lengths.begin();
+      deposits.push_back({&tours[best], 1.0, 1.0 / double(lengths[best])});
+      double p = std::pow(options_.max_min_p_best,
+                          1.0 / double(graph_->GetSize()));
+      double average = std::max(double(graph_->GetSize()) / 2.0, 2.0);
+      colony.tau_max = best_amount / rho;
+      colony.tau_min = std::min(
+          colony.tau_max * (1.0 - p) / ((average - 1.0) * p), colony.tau_max);
+      break;
+    }
+    case Variant::kAntColonySystem:
+      // The local update has been applied during ConstructToursTogether().
+      colony.keep = 1.0;
+      deposits.push_back({&colony.best_tour, 1.0 - rho, rho * best_amount});
+      break;
+  }
+  // Set here, before the rows are updated in parallel: the edges that get
+  // their first deposit start from it.
+  colony.tau_rest *= colony.keep;
+  if (options_.variant == Variant::kMaxMin) {
+    colony.tau_rest =
+        std::clamp(colony.tau_rest, colony.tau_min, colony.tau_max);
+  }
+}
+
+void Ant::UpdatePheromoneRows(Colony& colony, size_type row_begin,
+                              size_type row_end) {
+  PerfPhase phase("ant/pheromone_update");
+  auto size = graph_->GetSize();
+  auto columns = colony.pheromone_mx.GetCols();
+  bool max_min = options_.variant == Variant::kMaxMin;
+
+  if (colony.keep != 1.0) {
+    for (size_type i = row_begin; i < row_end; ++i) {
+      double* row = &colony.pheromone_mx(i, 0);
+      for (size_type j = 0; j < columns; ++j) {
+        row[j] *= colony.keep;
+      }
+      if (candidates_ > 0) {
+        for (Trail& trail : colony.off_candidate[i]) {
+          trail.tau *= colony.keep;
+        }
+      }
+    }
+  }
+  for (const Deposit& deposit : colony.deposits) {
+    const tour_t& tour = *deposit.tour;
+    for (size_type i = 0; i < size; ++i) {
+      auto from = tour[i];
+      if (from >= row_begin && from < row_end) {
+        double& tau = FindTrail(colony, from, tour[i + 1 < size ? i + 1 : 0]);
+        tau = tau * deposit.decay + deposit.amount;
+      }
+    }
+  }
+  for (size_type i = row_begin; i < row_end; ++i) {
+    if (max_min) {
+      double* row = &colony.pheromone_mx(i, 0);
+      for (size_type j = 0; j < columns; ++j) {
+        row[j] = std::clamp(row[j], colony.tau_min, colony.tau_max);
+      }
+    }
+    if (candidates_ > 0) {
+      // An edge back at tau_rest (after MMAS clamping) needs no trail.
+      auto& trails = colony.off_candidate[i];
+      for (Trail& trail : trails) {
+        if (max_min) {
+          trail.tau = std::clamp(trail.tau, colony.tau_min, colony.tau_max);
+        }
+      }
+      trails.erase(std::remove_if(trails.begin(), trails.end(),
+                                  [&colony](const Trail& trail) {
+                                    return trail.tau == colony.tau_rest;
+                                  }),
+                   trails.end());
+    }
+  }
+}
+
+void Ant::MigrateBestTours() {
+  auto count = colonies_.size();
+  std::vector<tour_t> migrants(count);
+  std::vector<size_type> lengths(count);
+  for (size_type i = 0; i < count; ++i) {
+    migrants[i] = colonies_[i].best_tour;
+    lengths[i] = colonies_[i].best_tour_distance;
+  }
+
+  // The adopted tour is reinforced like a global best: 1 / length, or the
+  // acs evaporation towards it for kAntColonySystem.
+  double rho = options_.evaporation_rate;
+  bool acs = options_.variant == Variant::kAntColonySystem;
+  for (size_type i = 0; i < count; ++i) {
+    Colony& colony = colonies_[i];
+    size_type from = (i + count - 1) % count;
+    if (lengths[from] < colony.best_tour_distance) {
+      double amount = 1.0 / double(lengths[from]);
+      colony.best_tour = std::move(migrants[from]);
+      colony.best_tour_distance = lengths[from];
+      colony.deposits.assign(
+          1, {&colony.best_tour, acs ? 1.0 - rho : 1.0,
+              acs ? rho * amount : amount});
+      colony.keep = 1.0;
+      UpdatePheromoneRows(colony, 0, graph_->GetSize());
+    }
+  }
+}
+
+double Ant::CalculateEntropy(const Colony& colony, size_type i) const {
+  auto size = graph_->GetSize();
+  if (size < 3) {
+    return 0.0;
+  }
+
+  // With candidate lists, the edges without a trail of their own all hold
+  // tau_rest and are counted together.
+  auto columns = colony.pheromone_mx.GetCols();
+  auto term = [](double tau, double total) {
+    double p = tau / total;
+    return tau > 0.0 ? -p * std::log(p) : 0.0;
+  };
+  const double* row = &colony.pheromone_mx(i, 0);
+  const Trail* trails = nullptr;
+  size_type trail_count = 0;
+  size_type rest = 0;
+  if (candidates_ > 0) {
+    trails = colony.off_candidate[i].data();
+    trail_count = colony.off_candidate[i].size();
+    rest = size - 1 - columns - trail_count;
+  }
+  double total = double(rest) * colony.tau_rest;
+  for (size_type j = 0; j < columns; ++j) {
+    total += ColumnCity(i, j) != i ? row[j] : 0.0;
+  }
+  for (size_type j = 0; j < trail_count; ++j) {
+    total += trails[j].tau;
+  }
+  double entropy = double(rest) * term(colony.tau_rest, total);
+  for (size_type j = 0; j < columns; ++j) {
+    if (ColumnCity(i, j) != i) {
+      entropy += term(row[j], total);
+    }
+  }
+  for (size_type j = 0; j < trail_count; ++j) {
+    entropy += term(trails[j].tau, total);
+  }
+  return entropy / std::log(double(size - 1));
 }
 
 Ant::size_type Ant::CalculateTotalDistance(const tour_t& tour) {
   size_type totalDistance = 0.0;
-  for (size_type i = 0; i < graph_.GetSize() - 1; ++i) {
+  for (size_type i = 0; i < graph_->GetSize() - 1; ++i) {
     auto city1 = tour[i];
     auto city2 = tour[i + 1];
-    totalDistance += graph_.GetWeight(city1, city2);
+    totalDistance += graph_->GetWeight(city1, city2);
   }
-  auto lastCity = tour[graph_.GetSize() - 1];
+  auto lastCity = tour[graph_->GetSize() - 1];
   auto firstCity = tour[0];
-  totalDistance += graph_.GetWeight(lastCity, firstCity);
+  totalDistance += graph_->GetWeight(lastCity, firstCity);
   return totalDistance;
 }
 
+Ant::size_type Ant::CalculateNearestNeighbourDistance() {
+  auto size = graph_->GetSize();
+  std::vector<bool> visited(size, false);
+  size_type current = 0;
+  size_type distance = 0;
+
+  visited[current] = true;
+  for (size_type step = 1; step < size; ++step) {
+    size_type next = size_type_max;
+    for (size_type city = 0; city < size; ++city) {
+      if (!visited[city] &&
+          (next == size_type_max || graph_->GetWeight(current, city) <
+                                        graph_->GetWeight(current, next))) {
+        next = city;
+      }
+    }
+    distance += graph_->GetWeight(current, next);
+    visited[next] = true;
+    current = next;
+  }
+  return distance + graph_->GetWeight(current, 0);
+}
+
 Ant::TsmResult Ant::Solve(bool parallel) {
-  parallel_ = parallel;
-  tour_t best_tour;
-  size_type best_tour_distance = size_type_max;
-  pheromone_mx_ = Matrix<double>{graph_.GetSize(), graph_.GetSize(), 1.0};
+  return Solve(clock::time_point::max(), parallel);
+}
+
+Ant::TsmResult Ant::Solve(ThreadPool& pool) {
+  return Solve(clock::time_point::max(), pool);
+}
+
+Ant::TsmResult Ant::Solve(clock::time_point deadline, bool parallel) {
+  if (parallel) {
+    return Solve(deadline, ThreadPool::Shared());
+  }
+  pool_ = nullptr;
+  parallel_ = false;
+  return Run(deadline);
+}
+
+Ant::TsmResult Ant::Solve(clock::time_point deadline, ThreadPool& pool) {
+  pool_ = &pool;
+  parallel_ = true;
+  return Run(deadline);
+}
 
-  if (parallel_) {
-    mu_.resize(graph_.GetSize());
-    for (auto& elm : mu_) {
-      elm = std::vector<std::mutex>(graph_.GetSize());
+void Ant::InitializeColony(Colony& colony, Xoshiro256& streams) {
+  auto size = graph_->GetSize();
+  auto columns = candidates_ > 0 ? candidates_ : size;
+  colony.pheromone_mx = Matrix<double>{size, columns, tau0_};
+  colony.choice_info_mx = Matrix<double>{size, columns, 0.0};
+  colony.off_candidate.assign(candidates_ > 0 ? size : 0, {});
+  colony.tau_rest = tau0_;
+  colony.tours.assign(options_.number_of_ants, tour_t(size));
+  colony.tour_lengths.assign(options_.number_of_ants, 0);
+  colony.generators.clear();
+  for (size_type ant = 0; ant < options_.number_of_ants; ++ant) {
+    colony.generators.push_back(streams);
+    streams.Jump();
+  }
+  colony.best_tour.clear();
+  colony.best_tour_distance = size_type_max;
+  colony.tau_max = tau0_;
+}
+
+Ant::TsmResult Ant::Run(clock::time_point deadline) {
+  if (!graph_) throw std::runtime_error("graph is not loaded");
+  auto size = graph_->GetSize();
+  // Local search without candidate lists uses lists of the default size.
+  auto candidates = options_.candidate_list_size;
+  if (candidates == 0 && options_.local_search != LocalSearchMode::kNone) {
+    candidates = LocalSearch::kDefaultNeighbours;
+  }
+  if (candidates > 0 &&
+      neighbours_.GetCount() != std::min(candidates, size - 1)) {
+    neighbours_ = NeighbourLists(*graph_, candidates);
+  }
+  // Kept until the next LoadGraph(): it refers to neighbours_ rather than
+  // copying the lists, and it checks the graph for symmetry only once.
+  if (options_.local_search != LocalSearchMode::kNone && !local_search_) {
+    local_search_ = std::make_unique<LocalSearch>(*graph_, neighbours_);
+  }
+  candidates_ = options_.candidate_list_size > 0 ? neighbours_.GetCount() : 0;
+  // A coordinate graph without candidate lists gets no n x n copy of its
+  // distances: UpdateChoiceInfo() computes them as it goes.
+  heuristic_mx_ = Matrix<double>();
+  if (candidates_ > 0 || graph_->GetLayout() != Graph::Layout::kCoordinates) {
+    auto columns = candidates_ > 0 ? candidates_ : size;
+    heuristic_mx_ = Matrix<double>{size, columns, 0.0};
+    for (size_type i = 0; i < size; ++i) {
+      for (size_type j = 0; j < columns; ++j) {
+        if (ColumnCity(i, j) != i) {
+          heuristic_mx_(i, j) = ComputeHeuristic(i, ColumnCity(i, j));
+        }
+      }
     }
-    pool_ = std::make_unique<ThreadPool>(std::thread::hardware_concurrency());
+  }
+  tau0_ = 1.0;
+  if (options_.variant == Variant::kMaxMin) {
+    tau0_ = 1.0 / (options_.evaporation_rate *
+                   double(CalculateNearestNeighbourDistance()));
+  } else if (options_.variant == Variant::kAntColonySystem) {
+    tau0_ = 1.0 / (double(size) * double(CalculateNearestNeighbourDistance()));
+  }
+  TsmResult result;
+  result.seed = options_.seed;
+  while (result.seed == 0) {
+    result.seed = (std::uint64_t(std::random_device()()) << 32) |
+                  std::random_device()();
+  }
+  Xoshiro256 streams(result.seed);
+  colonies_.resize(options_.colonies);
+  for (Colony& colony : colonies_) {
+    InitializeColony(colony, streams);
   }
 
-  for (size_type iteration = 0; iteration < max_iterations; ++iteration) {
-    UpdatePheromone();
-    auto tour = ConstructTour();
-    auto tour_distance = CalculateTotalDistance(tour);
+  // A single colony spreads every iteration over the pool; several colonies
+  // run concurrently for a whole epoch between migrations.
+  bool islands = colonies_.size() > 1;
+  std::vector<std::vector<double>> histories(colonies_.size());
+  std::vector<double> entropy(colonies_.size());
+  auto run_colony = [this, deadline, islands, &histories,
+                     &entropy](size_type index, size_type epoch) {
+    Colony& colony = colonies_[index];
+    histories[index].clear();
+    for (size_type i = 0; i < epoch; ++i) {
+      entropy[index] = RunIteration(colony, parallel_ && !islands);
+      histories[index].push_back(double(colony.best_tour_distance));
+      if (clock::now() >= deadline) {
+        break;
+      }
+    }
+  };
+
+  size_type stagnant = 0;
+  double best_distance = double(size_type_max);
+  while (result.iterations < options_.max_iterations) {
+    size_type epoch =
+        islands ? std::min(options_.migration_interval,
+                           options_.max_iterations - result.iterations)
+                : 1;
+    ForEach(colonies_.size(), parallel_ && islands,
+            [&run_colony, epoch](size_type index) {
+              run_colony(index, epoch);
+            });
+    if (islands) {
+      MigrateBestTours();
+    }
 
-    if (tour_distance < best_tour_distance) {
-      best_tour = tour;
-      best_tour_distance = tour_distance;
+    // The colonies may stop at different iterations near the deadline.
+    size_type done = 0;
+    for (const auto& history : histories) {
+      done = std::max(done, history.size());
+    }
+    for (size_type i = 0; i < done; ++i) {
+      double distance = best_distance;
+      for (const auto& history : histories) {
+        distance = std::min(distance, history[std::min(i, history.size() - 1)]);
+      }
+      stagnant = distance < best_distance ? 0 : stagnant + 1;
+      best_distance = distance;
+      result.history.push_back(distance);
+    }
+    result.iterations += done;
+
+    if (options_.stagnation_iterations > 0 &&
+        stagnant >= options_.stagnation_iterations) {
+      result.stop_reason = StopReason::kStagnation;
+      break;
+    } else if (*std::max_element(entropy.begin(), entropy.end()) <
+               options_.min_entropy) {
+      result.stop_reason = StopReason::kEntropy;
+      break;
+    } else if (clock::now() >= deadline) {
+      result.stop_reason = StopReason::kDeadline;
+      break;
     }
   }
-  for (auto& elm : best_tour) {
+
+  const Colony& best = *std::min_element(
+      colonies_.begin(), colonies_.end(), [](const Colony& a, const Colony& b) {
+        return a.best_tour_distance < b.best_tour_distance;
+      });
+  result.vertices = best.best_tour;
+  for (auto& elm : result.vertices) {
     ++elm;
   }
-  best_tour.push_back(best_tour[0]);
-  pool_.reset();
-  return {best_tour, double(best_tour_distance)};
-}
-
-void Ant::AddPheromoneValue(size_type i, size_type j, double value) {
-  if (parallel_) std::lock_guard lock(mu_[i][j]);
-  pheromone_mx_[i][j] += value;
+  result.vertices.push_back(result.vertices[0]);
+  result.distance = double(best.best_tour_distance);
+  return result;
 }
 
 }  // namespace s21
@@ -23,8 +23,13 @@ bool ProcessMenu() {
       case 1:
         std::cout << "\tEnter path and filename\n";
         std::cin >> filename;
-        graph.LoadGraphFromFile(filename);
-        graph.GetAdjacencyMatrix().PrintFull();
+        if (std::filesystem::path(filename).extension() == ".tsp") {
+          graph.LoadTsplibFromFile(filename);
+          std::cout << "\tLoaded " << graph.GetSize() << " cities\n";
+        } else {
+          graph.LoadGraphFromFile(filename);
+          graph.GetAdjacencyMatrix().PrintFull();
+        }
         ant.LoadGraph(graph);
         break;
       case 2:
@@ -1,70 +1,348 @@
 #include "ant/graph.h"
 
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
 namespace s21 {
 
-void Graph::LoadGraphFromFile(const std::string& filename) {
+namespace {
+
+std::string Trim(const std::string& text) {
+  auto begin = text.find_first_not_of(" \t\r");
+  if (begin == std::string::npos) {
+    return {};
+  }
+  return text.substr(begin, text.find_last_not_of(" \t\r") - begin + 1);
+}
+
+// TSPLIB GEO coordinates are DDD.MM, degrees and minutes.
+double GeoToRadians(double coordinate) {
+  constexpr double kPi = 3.141592;
+  double degrees = std::trunc(coordinate);
+  double minutes = coordinate - degrees;
+  return kPi * (degrees + 5.0 * minutes / 3.0) / 180.0;
+}
+
+}  // namespace
+
+template <class W>
+void BasicGraph<W>::LoadGraphFromFile(const std::string& filename) {
+  // Binary weights are read in place in no particular order for as long as
+  // the graph lives; text is parsed once from start to end.
+  auto file = std::make_shared<const MappedFile>(filename,
+                                                 MappedFile::Access::kRandom);
+  if (!LoadBinary(file)) {
+    file->Advise(MappedFile::Access::kSequential);
+    LoadText(file->GetView());
+  }
+}
+
+template <class W>
+void BasicGraph<W>::LoadTsplibFromFile(const std::string& filename) {
   std::ifstream file(filename);
+  if (!file.is_open()) {
+    throw std::runtime_error("The file cannot be opened");
+  }
+  Clear();
 
-  if (file.is_open()) {
-    adjacency_matrix.ReadFull(file);
-    file.close();
+  std::string line;
+  std::string edge_weight_type;
+  size_type dimension = 0;
+  bool coordinates = false;
+  // In the data of a section other than NODE_COORD_SECTION, which is
+  // skipped up to the next keyword.
+  bool skipping = false;
+  while (!coordinates && std::getline(file, line)) {
+    line = Trim(line);
+    if (line.empty()) {
+      continue;
+    } else if (line == "NODE_COORD_SECTION") {
+      coordinates = true;
+      continue;
+    } else if (line == "EOF") {
+      break;
+    } else if (line.size() > 8 &&
+               line.compare(line.size() - 8, 8, "_SECTION") == 0) {
+      skipping = true;
+      continue;
+    } else if (skipping && !std::isalpha(static_cast<unsigned char>(line[0]))) {
+      continue;
+    }
+    skipping = false;
+    auto colon = line.find(':');
+    if (colon == std::string::npos) {
+      throw std::invalid_argument("Incorrect data format");
+    }
+    auto key = Trim(line.substr(0, colon));
+    auto value = Trim(line.substr(colon + 1));
+    if (key == "DIMENSION") {
+      std::istringstream(value) >> dimension;
+    } else if (key == "EDGE_WEIGHT_TYPE") {
+      edge_weight_type = value;
+    }
+  }
+  if (!coordinates || dimension == 0) {
+    throw std::invalid_argument("Incorrect data format");
+  } else if (edge_weight_type != "EUC_2D" && edge_weight_type != "GEO") {
+    throw std::invalid_argument("Unsupported edge weight type");
+  }
 
-    if (adjacency_matrix.GetRows() != adjacency_matrix.GetCols()) {
-      throw std::invalid_argument("The matrix must be square");
+  std::vector<double> x(dimension);
+  std::vector<double> y(dimension);
+  std::vector<bool> seen(dimension, false);
+  for (size_type i = 0; i < dimension; ++i) {
+    size_type id = 0;
+    double node_x = 0.0;
+    double node_y = 0.0;
+    if (!(file >> id >> node_x >> node_y) || id == 0 || id > dimension ||
+        seen[id - 1]) {
+      throw std::invalid_argument("Incorrect data format");
     }
+    seen[id - 1] = true;
+    x[id - 1] = node_x;
+    y[id - 1] = node_y;
+  }
 
-    for (size_type i = 0; i < adjacency_matrix.GetRows(); ++i) {
-      for (size_type j = 0; j < adjacency_matrix.GetCols(); ++j) {
-        if (i != j && adjacency_matrix[i][j] == 0) {
-          adjacency_matrix[i][j] = size_type_max;
-        }
-      }
+  if (edge_weight_type == "GEO") {
+    metric_ = Metric::kGeographical;
+    std::transform(x.begin(), x.end(), x.begin(), GeoToRadians);
+    std::transform(y.begin(), y.end(), y.begin(), GeoToRadians);
+  } else {
+    // No distance exceeds the diagonal of the bounding box. GEO distances
+    // are at most half the Earth's circumference.
+    auto [min_x, max_x] = std::minmax_element(x.begin(), x.end());
+    auto [min_y, max_y] = std::minmax_element(y.begin(), y.end());
+    double diagonal = std::hypot(*max_x - *min_x, *max_y - *min_y);
+    if (!(std::round(diagonal) < double(weight_max))) {
+      throw std::invalid_argument("The weight is too large");
     }
+    metric_ = Metric::kEuclidean;
+  }
+  x_ = std::move(x);
+  y_ = std::move(y);
+  layout_ = Layout::kCoordinates;
+  size_ = dimension;
+}
+
+template <class W>
+bool BasicGraph<W>::LoadBinary(const std::shared_ptr<const MappedFile>& file) {
+  auto header = ReadBinaryHeader(file->GetView());
+  if (!header) {
+    return false;
+  } else if (header->layout == BinaryLayout::kMatrix) {
+    // Its zeros would be edges of weight 0 rather than missing ones.
+    throw std::invalid_argument("Binary matrix files are not graphs");
+  } else if (header->rows != header->cols) {
+    throw std::invalid_argument("The matrix must be square");
+  }
+
+  Clear();
+  bool symmetric = header->layout == BinaryLayout::kGraphSymmetric;
+  size_type size = header->rows;
+  weights_ = GetBinaryData<weight_type>(file->GetView(), *header);
+  storage_ = file;
+  layout_ = symmetric ? Layout::kSymmetric : Layout::kFull;
+  size_ = size;
+  return true;
+}
+
+template <class W>
+void BasicGraph<W>::LoadText(std::string_view text) {
+  size_type size = 0;
+  auto lower = std::make_shared<std::vector<weight_type>>();
+  auto full = std::make_shared<std::vector<weight_type>>();
+  auto at = [](size_type i, size_type j) {
+    return i < j ? j * (j + 1) / 2 + i : i * (i + 1) / 2 + j;
+  };
+  auto weight = [](size_type i, size_type j, weight_type value) {
+    if (value >= weight_max) {
+      throw std::invalid_argument("The weight is too large");
+    }
+    return i != j && value == 0 ? weight_max : value;
+  };
+  AdjacencyMatrix::ParseRows(
+      text,
+      [&size, &lower, &text](size_type rows, size_type cols) {
+        if (rows != cols) {
+          throw std::invalid_argument("The matrix must be square");
+        } else if (rows * rows > text.size() / 2) {
+          // Every value takes at least two bytes.
+          throw std::invalid_argument("Incorrect data format");
+        }
+        size = rows;
+        lower->assign(size * (size + 1) / 2, weight_type());
+      },
+      [&](size_type i, const weight_type* row) {
+        if (!lower->empty()) {
+          bool symmetric = true;
+          for (size_type j = 0; j < i && symmetric; ++j) {
+            symmetric = (*lower)[at(i, j)] == weight(i, j, row[j]);
+          }
+          if (symmetric) {
+            for (size_type j = i; j < size; ++j) {
+              (*lower)[at(i, j)] = weight(i, j, row[j]);
+            }
+            return;
+          }
+          // Rows 0..i - 1 are all in the triangle, either way round.
+          full->reserve(size * size);
+          for (size_type r = 0; r < i; ++r) {
+            for (size_type c = 0; c < size; ++c) {
+              full->push_back((*lower)[at(r, c)]);
+            }
+          }
+          lower->clear();
+          lower->shrink_to_fit();
+        }
+        for (size_type j = 0; j < size; ++j) {
+          full->push_back(weight(i, j, row[j]));
+        }
+      });
+
+  Clear();
+  size_ = size;
+  if (full->empty()) {
+    layout_ = Layout::kSymmetric;
+    weights_ = lower->data();
+    storage_ = std::move(lower);
   } else {
-    throw std::runtime_error("The file cannot be opened");
+    layout_ = Layout::kFull;
+    weights_ = full->data();
+    storage_ = std::move(full);
   }
 }
 
-bool Graph::IsComplete() const noexcept {
-  for (size_type i = 0; i < adjacency_matrix.GetRows(); ++i) {
-    for (size_type j = 0; j < adjacency_matrix.GetCols(); ++j) {
-      if (adjacency_matrix[i][j] == size_type_max) {
-        return false;
+template <class W>
+void BasicGraph<W>::SaveGraphToBinaryFile(const std::string& filename) const {
+  std::vector<weight_type> distances;
+  const weight_type* weights = weights_;
+  auto layout = layout_ == Layout::kFull ? BinaryLayout::kGraphFull
+                                         : BinaryLayout::kGraphSymmetric;
+  if (layout_ == Layout::kCoordinates) {
+    distances.reserve(size_ * (size_ + 1) / 2);
+    for (size_type i = 0; i < size_; ++i) {
+      for (size_type j = 0; j <= i; ++j) {
+        distances.push_back(ComputeDistance(i, j));
       }
     }
+    weights = distances.data();
   }
+  auto count = layout_ == Layout::kFull ? size_ * size_
+                                        : size_ * (size_ + 1) / 2;
+  WriteBinaryFile(filename, DataTypeOf<weight_type>::value, layout, size_,
+                  size_, weights, count * sizeof(weight_type));
+}
 
-  return true;
+template <class W>
+void BasicGraph<W>::Clear() {
+  size_ = 0;
+  layout_ = Layout::kFull;
+  storage_.reset();
+  weights_ = nullptr;
+  x_.clear();
+  y_.clear();
 }
 
-bool Graph::IsWeighted() const noexcept {
-  for (size_type i = 0; i < adjacency_matrix.GetRows(); ++i) {
-    for (size_type j = 0; j < adjacency_matrix.GetCols(); ++j) {
-      if (adjacency_matrix[i][j] > 1 &&
-          adjacency_matrix[i][j] < size_type_max) {
-        return true;
+template <class W>
+typename BasicGraph<W>::size_type BasicGraph<W>::GetWeightCount()
+    const noexcept {
+  switch (layout_) {
+    case Layout::kFull:
+      return size_ * size_;
+    case Layout::kSymmetric:
+      return size_ * (size_ + 1) / 2;
+    default:
+      return 0;
+  }
+}
+
+template <class W>
+bool BasicGraph<W>::IsComplete() const noexcept {
+  if (layout_ == Layout::kCoordinates) {
+    return true;
+  }
+  return std::find(weights_, weights_ + GetWeightCount(), weight_max) ==
+         weights_ + GetWeightCount();
+}
+
+template <class W>
+bool BasicGraph<W>::IsWeighted() const noexcept {
+  if (layout_ == Layout::kCoordinates) {
+    for (size_type i = 0; i < size_; ++i) {
+      for (size_type j = 0; j < i; ++j) {
+        if (ComputeDistance(i, j) > 1) {
+          return true;
+        }
       }
     }
+    return false;
   }
-
-  return false;
+  return std::any_of(weights_, weights_ + GetWeightCount(),
+                     [](weight_type weight) {
+                       return weight > 1 && weight < weight_max;
+                     });
 }
 
-Graph::size_type Graph::GetWeight(size_type vertex_a,
-                                  size_type vertex_b) const {
-  return adjacency_matrix[vertex_a][vertex_b];
+template <class W>
+bool BasicGraph<W>::IsLoaded() const noexcept {
+  return size_ > 0;
 }
 
-bool Graph::IsLoaded() const noexcept {
-  return adjacency_matrix.GetRows() > 0 && adjacency_matrix.GetCols() > 0;
+template <class W>
+typename BasicGraph<W>::Layout BasicGraph<W>::GetLayout() const noexcept {
+  return layout_;
 }
 
-Graph::AdjacencyMatrix Graph::GetAdjacencyMatrix() const noexcept {
+template <class W>
+typename BasicGraph<W>::AdjacencyMatrix BasicGraph<W>::GetAdjacencyMatrix()
+    const {
+  AdjacencyMatrix adjacency_matrix(size_, size_);
+  for (size_type i = 0; i < size_; ++i) {
+    for (size_type j = 0; j < size_; ++j) {
+      adjacency_matrix[i][j] = GetWeight(i, j);
+    }
+  }
   return adjacency_matrix;
 }
 
-Graph::size_type Graph::GetSize() const noexcept {
-  return adjacency_matrix.GetRows();
+template <class W>
+typename BasicGraph<W>::size_type BasicGraph<W>::GetSize() const noexcept {
+  return size_;
+}
+
+template class BasicGraph<std::uint32_t>;
+
+NeighbourLists::NeighbourLists(const Graph& graph, size_type count) {
+  size_type size = graph.GetSize();
+  count_ = size > 0 ? std::min(count, size - 1) : 0;
+  neighbours_.assign(size * count_, 0);
+  std::vector<size_type> others(size > 0 ? size - 1 : 0);
+  // Fetched once per vertex: coordinate graphs compute every weight.
+  std::vector<Graph::weight_type> row(size);
+
+  for (size_type vertex = 0; vertex < size; ++vertex) {
+    for (size_type i = 0, other = 0; other < size; ++other) {
+      row[other] = graph.GetWeight(vertex, other);
+      if (other != vertex) {
+        others[i++] = other;
+      }
+    }
+    std::partial_sort(others.begin(), others.begin() + count_, others.end(),
+                      [&row](size_type a, size_type b) {
+                        return row[a] < row[b] || (row[a] == row[b] && a < b);
+                      });
+    std::copy(others.begin(), others.begin() + count_,
+              neighbours_.begin() + vertex * count_);
+  }
+}
+
+NeighbourLists::size_type NeighbourLists::GetCount() const noexcept {
+  return count_;
+}
+
+const NeighbourLists::size_type* NeighbourLists::Get(size_type vertex) const {
+  return neighbours_.data() + vertex * count_;
 }
 
 }  // namespace s21
@@ -0,0 +1,238 @@
+#include "ant/local_search.h"
+
+#include <algorithm>
+#include <deque>
+
+#include "common/perf_counters.h"
+
+namespace s21 {
+
+namespace {
+constexpr double kEpsilon = 1e-9;
+}  // namespace
+
+struct LocalSearch::State {
+  explicit State(tour_t& tour)
+      : tour(tour), size(tour.size()), pos(size), active(size, true) {
+    for (size_type i = 0; i < size; ++i) {
+      pos[tour[i]] = i;
+      queue.push_back(tour[i]);
+    }
+  }
+
+  size_type Next(size_type city) const { return tour[(pos[city] + 1) % size]; }
+  size_type Prev(size_type city) const {
+    return tour[(pos[city] + size - 1) % size];
+  }
+  void Activate(size_type city) {
+    if (!active[city]) {
+      active[city] = true;
+      queue.push_back(city);
+    }
+  }
+
+  tour_t& tour;
+  size_type size;
+  std::vector<size_type> pos;
+  std::vector<bool> active;
+  std::deque<size_type> queue;
+};
+
+LocalSearch::LocalSearch(const Graph& graph, const NeighbourLists& neighbours)
+    : graph_(graph),
+      neighbours_(neighbours),
+      symmetric_(graph.GetLayout() != Graph::Layout::kFull) {
+  // Only a full matrix can be asymmetric; the other layouts are symmetric by
+  // construction, and a coordinate graph would compute every weight twice.
+  if (symmetric_) {
+    return;
+  }
+  symmetric_ = true;
+  for (size_type i = 0; i < graph.GetSize() && symmetric_; ++i) {
+    for (size_type j = i + 1; j < graph.GetSize(); ++j) {
+      if (graph.GetWeight(i, j) != graph.GetWeight(j, i)) {
+        symmetric_ = false;
+        break;
+      }
+    }
+  }
+}
+
+bool LocalSearch::Improve(tour_t& tour) const {
+  if (!symmetric_ || tour.size() < 4 || neighbours_.GetCount() == 0) {
+    return false;
+  }
+  PerfPhase phase("ant/local_search");
+
+  State state(tour);
+  bool improved = false;
+
+  while (!state.queue.empty()) {
+    size_type city = state.queue.front();
+    state.queue.pop_front();
+    state.active[city] = false;
+    if (TryTwoOpt(state, city) || TryOrOpt(state, city)) {
+      improved = true;
+    }
+  }
+
+  return improved;
+}
+
+bool LocalSearch::TryTwoOpt(State& state, size_type a) const {
+  const size_type* neighbours = neighbours_.Get(a);
+
+  for (bool forward : {true, false}) {
+    size_type b = forward ? state.Next(a) : state.Prev(a);
+    double ab = Weight(a, b);
+
+    for (size_type i = 0; i < neighbours_.GetCount(); ++i) {
+      size_type c = neighbours[i];
+      double ac = Weight(a, c);
+      if (ac >= ab) {
+        break;
+      }
+      size_type d = forward ? state.Next(c) : state.Prev(c);
+      if (c == b || d == a) {
+        continue;
+      }
+      if (ac + Weight(b, d) - ab - Weight(c, d) < -kEpsilon) {
+        // a b ... c d -> a c ... b d, or d c ... b a -> d b ... c a.
+        if (forward) {
+          Reverse(state, b, c);
+        } else {
+          Reverse(state, c, b);
+        }
+        for (size_type city : {a, b, c, d}) {
+          state.Activate(city);
+        }
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+bool LocalSearch::TryOrOpt(State& state, size_type first) const {
+  std::size_t n = state.size;
+
+  for (size_type length = 1; length <= kMaxSegment && length + 3 <= n;
+       ++length) {
+    size_type last = state.tour[(state.pos[first] + length - 1) % n];
+    size_type prev = state.Prev(first);
+    size_type next = state.Next(last);
+    double removal = Weight(prev, first) + Weight(last, next) -
+                     Weight(prev, next);
+    if (removal <= kEpsilon) {
+      continue;
+    }
+    auto inside = [&state, first, length, n](size_type city) {
+      return (state.pos[city] + n - state.pos[first]) % n < length;
+    };
+
+    for (size_type end : {first, last}) {
+      const size_type* neighbours = neighbours_.Get(end);
+      size_type other = end == first ? last : first;
+
+      for (size_type i = 0; i < neighbours_.GetCount(); ++i) {
+        size_type c = neighbours[i];
+        double end_c = Weight(end, c);
+        if (end_c >= removal) {
+          break;
+        }
+        if (inside(c)) {
+          continue;
+        }
+        // Insert between c and its successor or between its predecessor and
+        // c, with `end` next to c in both cases.
+        for (bool after_c : {true, false}) {
+          size_type d = after_c ? state.Next(c) : state.Prev(c);
+          if (inside(d)) {
+            continue;
+          }
+          double insertion = end_c + Weight(other, d) - Weight(c, d);
+          if (insertion - removal < -kEpsilon) {
+            bool reversed = after_c == (end == last);
+            MoveSegment(state, first, length, after_c ? c : d, reversed);
+            for (size_type city : {prev, next, first, last, c, d}) {
+              state.Activate(city);
+            }
+            return true;
+          }
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+void LocalSearch::Reverse(State& state, size_type from, size_type to) const {
+  std::size_t n = state.size;
+  size_type i = state.pos[from];
+  size_type j = state.pos[to];
+  size_type length = (j + n - i) % n + 1;
+
+  // Reversing the complementary path gives the same cycle mirrored.
+  if (2 * length > n) {
+    std::swap(i, j);
+    i = (i + 1) % n;
+    j = (j + n - 1) % n;
+    length = n - length;
+  }
+  for (size_type k = 0; k < length / 2; ++k) {
+    std::swap(state.tour[i], state.tour[j]);
+    state.pos[state.tour[i]] = i;
+    state.pos[state.tour[j]] = j;
+    i = (i + 1) % n;
+    j = (j + n - 1) % n;
+  }
+}
+
+void LocalSearch::MoveSegment(State& state, size_type first, size_type length,
+                              size_type after, bool reversed) const {
+  std::size_t n = state.size;
+  size_type begin = state.pos[first];
+  size_type target = state.pos[after];
+  size_type segment[kMaxSegment];
+  for (size_type k = 0; k < length; ++k) {
+    segment[k] = state.tour[(begin + k) % n];
+  }
+  if (reversed) {
+    std::reverse(segment, segment + length);
+  }
+  auto put = [&state, n](size_type i, size_type city) {
+    i %= n;
+    state.tour[i] = city;
+    state.pos[city] = i;
+  };
+
+  // Only the cities between the segment and `after` move, on whichever side
+  // of the cycle is shorter: those after the segment are shifted back over
+  // it, or those before it are shifted forward.
+  size_type ahead = (target + 2 * n - begin - length + 1) % n;
+  size_type behind = n - length - ahead;
+  if (ahead <= behind) {
+    for (size_type k = 0; k < ahead; ++k) {
+      put(begin + k, state.tour[(begin + length + k) % n]);
+    }
+    for (size_type k = 0; k < length; ++k) {
+      put(begin + ahead + k, segment[k]);
+    }
+  } else {
+    size_type start = target + 1;
+    for (size_type k = behind; k-- > 0;) {
+      put(start + length + k, state.tour[(start + k) % n]);
+    }
+    for (size_type k = 0; k < length; ++k) {
+      put(start + k, segment[k]);
+    }
+  }
+}
+
+double LocalSearch::Weight(size_type a, size_type b) const {
+  return double(graph_.GetWeight(a, b));
+}
+
+}  // namespace s21
@@ -0,0 +1,152 @@
+#include "common/benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace s21 {
+
+namespace {
+
+std::string Escape(const std::string& text) {
+  std::string escaped;
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else if (c == '\t') {
+      escaped += "\\t";
+    } else if (c == '\r') {
+      escaped += "\\r";
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      // The other control characters have no short escape in JSON.
+      static constexpr char kHex[] = "0123456789abcdef";
+      escaped += "\\u00";
+      escaped += kHex[c >> 4];
+      escaped += kHex[c & 0xf];
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+void WritePhasesJson(std::ostream& os,
+                     const std::vector<PerfCounters::Sample>& phases) {
+  os << ",\n      \"phases\": [";
+  for (std::size_t i = 0; i < phases.size(); ++i) {
+    os << (i ? ",\n" : "\n") << "        {\"phase\": \""
+       << Escape(phases[i].phase) << "\", \"thread\": " << phases[i].thread
+       << ", \"calls\": " << phases[i].calls;
+    for (std::size_t event = 0; event < PerfCounters::kEventCount; ++event) {
+      auto counter = PerfCounters::Event(event);
+      if (PerfCounters::IsAvailable(counter)) {
+        os << ", \"" << PerfCounters::GetEventName(counter)
+           << "\": " << phases[i].values[event];
+      }
+    }
+    os << '}';
+  }
+  os << "\n      ]";
+}
+
+}  // namespace
+
+Benchmark::Benchmark(const Options& options) : options_(options) {
+  if (options_.min_iterations == 0 ||
+      options_.max_iterations < options_.min_iterations) {
+    throw std::invalid_argument(
+        "The iteration limits must be positive and ordered");
+  }
+}
+
+const std::vector<Benchmark::Result>& Benchmark::GetResults() const noexcept {
+  return results_;
+}
+
+void Benchmark::AddResult(const std::string& name,
+                          const Parameters& parameters, double work,
+                          const std::string& unit,
+                          std::vector<double>& samples) {
+  std::sort(samples.begin(), samples.end());
+  auto rank = [&samples](double quantile) {
+    auto index = std::size_t(std::ceil(quantile * double(samples.size())));
+    return samples[std::clamp<std::size_t>(index, 1, samples.size()) - 1];
+  };
+
+  Result result;
+  result.name = name;
+  result.parameters = parameters;
+  result.iterations = samples.size();
+  result.min_ns = samples.front();
+  result.median_ns = samples.size() % 2
+                         ? samples[samples.size() / 2]
+                         : (samples[samples.size() / 2 - 1] +
+                            samples[samples.size() / 2]) /
+                               2.0;
+  result.p99_ns = rank(0.99);
+  result.mean_ns = std::accumulate(samples.begin(), samples.end(), 0.0) /
+                   double(samples.size());
+  result.throughput = work / (result.median_ns * 1e-9);
+  result.throughput_unit = unit;
+  results_.push_back(std::move(result));
+}
+
+void Benchmark::PrintTable(std::ostream& os) const {
+  os << std::left << std::setw(40) << "benchmark" << std::right
+     << std::setw(8) << "iters" << std::setw(14) << "min, ns"
+     << std::setw(14) << "median, ns" << std::setw(14) << "p99, ns"
+     << std::setw(14) << "throughput" << '\n';
+  for (const Result& result : results_) {
+    std::string name = result.name;
+    for (const auto& [key, value] : result.parameters) {
+      std::ostringstream parameter;
+      parameter << '/' << key << ':' << value;
+      name += parameter.str();
+    }
+    os << std::left << std::setw(40) << name << std::right << std::fixed
+       << std::setprecision(0) << std::setw(8) << result.iterations
+       << std::setw(14) << result.min_ns << std::setw(14) << result.median_ns
+       << std::setw(14) << result.p99_ns << std::setprecision(2)
+       << std::setw(14) << result.throughput << ' ' << result.throughput_unit
+       << '\n';
+  }
+}
+
+void Benchmark::WriteJson(std::ostream& os) const {
+  os << std::setprecision(17);
+  os << "{\n  \"context\": {\n"
+     << "    \"hardware_threads\": " << std::thread::hardware_concurrency()
+     << ",\n    \"compiler\": \"" << Escape(__VERSION__) << "\"\n  },\n"
+     << "  \"benchmarks\": [";
+  for (std::size_t i = 0; i < results_.size(); ++i) {
+    const Result& result = results_[i];
+    os << (i ? ",\n" : "\n") << "    {\n      \"name\": \""
+       << Escape(result.name) << "\",\n      \"parameters\": {";
+    for (std::size_t j = 0; j < result.parameters.size(); ++j) {
+      os << (j ? ", " : "") << '"' << Escape(result.parameters[j].first)
+         << "\": " << result.parameters[j].second;
+    }
+    os << "},\n      \"iterations\": " << result.iterations
+       << ",\n      \"min_ns\": " << result.min_ns
+       << ",\n      \"median_ns\": " << result.median_ns
+       << ",\n      \"p99_ns\": " << result.p99_ns
+       << ",\n      \"mean_ns\": " << result.mean_ns
+       << ",\n      \"throughput\": " << result.throughput
+       << ",\n      \"throughput_unit\": \"" << Escape(result.throughput_unit)
+       << '"';
+    if (!result.phases.empty()) {
+      WritePhasesJson(os, result.phases);
+    }
+    os << "\n    }";
+  }
+  os << "\n  ]\n}\n";
+}
+
+}  // namespace s21
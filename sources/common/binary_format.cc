@@ -0,0 +1,82 @@
+#include "common/binary_format.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace s21 {
+
+void WriteBinaryFile(const std::string& filename, DataType data_type,
+                     BinaryLayout layout, std::uint64_t rows,
+                     std::uint64_t cols, const void* data, std::size_t size) {
+  BinaryHeader header{};
+  std::copy(std::begin(BinaryHeader::kMagic), std::end(BinaryHeader::kMagic),
+            header.magic);
+  header.version = BinaryHeader::kVersion;
+  header.byte_order = BinaryHeader::kByteOrder;
+  header.data_type = data_type;
+  header.layout = layout;
+  header.rows = rows;
+  header.cols = cols;
+  header.alignment = BinaryHeader::kAlignment;
+  header.data_offset = BinaryHeader::kAlignment;
+  header.data_size = size;
+
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error("The file cannot be opened");
+  }
+  std::vector<char> padding(header.data_offset - sizeof(header), 0);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(padding.data(), std::streamsize(padding.size()));
+  file.write(static_cast<const char*>(data), std::streamsize(size));
+  if (!file) {
+    throw std::runtime_error("The file cannot be written");
+  }
+}
+
+std::optional<BinaryHeader> ReadBinaryHeader(std::string_view file) {
+  BinaryHeader header;
+  if (file.size() < sizeof(header) ||
+      !std::equal(std::begin(BinaryHeader::kMagic),
+                  std::end(BinaryHeader::kMagic), file.data())) {
+    return std::nullopt;
+  }
+  std::memcpy(&header, file.data(), sizeof(header));
+
+  if (header.version != BinaryHeader::kVersion) {
+    throw std::invalid_argument("Unsupported file version");
+  } else if (header.byte_order != BinaryHeader::kByteOrder ||
+             header.alignment == 0 ||
+             header.data_offset % header.alignment != 0 ||
+             header.data_offset < sizeof(header) ||
+             header.data_offset > file.size() ||
+             header.data_size > file.size() - header.data_offset) {
+    throw std::invalid_argument("Incorrect data format");
+  }
+  return header;
+}
+
+std::uint64_t GetBinaryValueCount(const BinaryHeader& header,
+                                  std::size_t value_size) {
+  std::uint64_t rows = header.rows;
+  std::uint64_t cols = header.cols;
+  if (header.layout == BinaryLayout::kGraphSymmetric) {
+    // rows (rows + 1) / 2, halving the even factor first.
+    if (rows == std::numeric_limits<std::uint64_t>::max()) {
+      throw std::invalid_argument("Incorrect data format");
+    }
+    cols = rows % 2 == 0 ? (rows + 1) : (rows + 1) / 2;
+    rows = rows % 2 == 0 ? rows / 2 : rows;
+  }
+  std::uint64_t count = rows * cols;
+  if ((rows != 0 && count / rows != cols) ||
+      count > std::numeric_limits<std::uint64_t>::max() / value_size) {
+    throw std::invalid_argument("Incorrect data format");
+  }
+  return count;
+}
+
+}  // namespace s21
@@ -0,0 +1,80 @@
+#include "common/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <utility>
+
+namespace s21 {
+
+MappedFile::MappedFile(const std::string& filename, Access access) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  struct stat info {};
+  if (fd < 0 || fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    throw std::runtime_error("The file cannot be opened");
+  }
+
+  size_ = std::size_t(info.st_size);
+  if (size_ > 0) {
+    void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      throw std::runtime_error("The file cannot be opened");
+    }
+    data_ = static_cast<const char*>(data);
+    Advise(access);
+  }
+  close(fd);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    Release();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() { Release(); }
+
+const char* MappedFile::GetData() const noexcept { return data_; }
+
+std::size_t MappedFile::GetSize() const noexcept { return size_; }
+
+std::string_view MappedFile::GetView() const noexcept {
+  return {data_, size_};
+}
+
+void MappedFile::Advise(Access access) const noexcept {
+  if (!data_) {
+    return;
+  }
+  int advice = MADV_NORMAL;
+  if (access == Access::kSequential) {
+    advice = MADV_SEQUENTIAL;
+  } else if (access == Access::kRandom) {
+    advice = MADV_RANDOM;
+  }
+  madvise(const_cast<char*>(data_), size_, advice);
+}
+
+void MappedFile::Release() noexcept {
+  if (data_) {
+    munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+}
+
+}  // namespace s21
@@ -0,0 +1,247 @@
+#include "common/perf_counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace s21 {
+
+namespace {
+
+using Values = std::array<std::uint64_t, PerfCounters::kEventCount>;
+
+struct Totals {
+  std::uint64_t calls{};
+  Values values{};
+};
+
+// The counts of one thread, kept by the registry after the thread exits so
+// that they can still be collected.
+struct ThreadCounters {
+  std::mutex mtx;
+  std::size_t generation{std::numeric_limits<std::size_t>::max()};
+  std::size_t index{};
+  std::unordered_map<const char*, Totals> totals;
+  std::atomic<bool> alive{true};
+};
+
+struct Registry {
+  std::mutex mtx;
+  std::vector<std::shared_ptr<ThreadCounters>> threads;
+  std::atomic<std::size_t> generation{};
+  std::size_t next_index{};
+  std::array<std::atomic<bool>, PerfCounters::kEventCount> available{};
+};
+
+Registry& GetRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+// The counter group of the calling thread, led by the task clock. Reading the
+// leader with PERF_FORMAT_GROUP returns the opened events in opening order.
+class ThreadGroup {
+ public:
+  ThreadGroup() : counters_(std::make_shared<ThreadCounters>()) {
+    fds_.fill(-1);
+    Open();
+    Registry& registry = GetRegistry();
+    std::lock_guard lock(registry.mtx);
+    registry.threads.push_back(counters_);
+  }
+  ThreadGroup(const ThreadGroup&) = delete;
+  ThreadGroup& operator=(const ThreadGroup&) = delete;
+  ~ThreadGroup() {
+#ifdef __linux__
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+#endif
+    counters_->alive = false;
+  }
+
+  [[nodiscard]] bool IsOpen() const noexcept {
+    return fds_[PerfCounters::kTaskClock] >= 0;
+  }
+  [[nodiscard]] bool IsOpen(PerfCounters::Event event) const noexcept {
+    return fds_[event] >= 0;
+  }
+
+  Values Read() const noexcept {
+    Values values{};
+#ifdef __linux__
+    std::uint64_t buffer[PerfCounters::kEventCount + 1]{};
+    if (read(fds_[PerfCounters::kTaskClock], buffer, sizeof(buffer)) <= 0) {
+      return values;
+    }
+    for (std::size_t event = 0, slot = 1; event < values.size(); ++event) {
+      if (fds_[event] >= 0) {
+        values[event] = buffer[slot++];
+      }
+    }
+#endif
+    return values;
+  }
+
+  void Charge(const char* phase, const Values& from, const Values& to,
+              std::uint64_t calls) {
+    Registry& registry = GetRegistry();
+    if (counters_->generation != registry.generation.load()) {
+      std::lock_guard registry_lock(registry.mtx);
+      std::lock_guard lock(counters_->mtx);
+      counters_->totals.clear();
+      counters_->index = registry.next_index++;
+      counters_->generation = registry.generation;
+    }
+    std::lock_guard lock(counters_->mtx);
+    Totals& totals = counters_->totals[phase];
+    totals.calls += calls;
+    for (std::size_t event = 0; event < to.size(); ++event) {
+      totals.values[event] += to[event] - from[event];
+    }
+  }
+
+  // The open phases, innermost last, with the counts at which each one was
+  // last resumed.
+  std::vector<std::pair<const char*, Values>> stack;
+
+ private:
+  void Open() {
+#ifdef __linux__
+    static constexpr std::pair<std::uint32_t, std::uint64_t>
+        kEvents[PerfCounters::kEventCount] = {
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}};
+    for (std::size_t event = 0; event < fds_.size(); ++event) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = kEvents[event].first;
+      attr.config = kEvents[event].second;
+      attr.read_format = PERF_FORMAT_GROUP;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      int leader = fds_[PerfCounters::kTaskClock];
+      fds_[event] =
+          int(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+      if (fds_[PerfCounters::kTaskClock] < 0) {
+        return;
+      }
+    }
+#endif
+  }
+
+  std::array<int, PerfCounters::kEventCount> fds_{};
+  std::shared_ptr<ThreadCounters> counters_;
+};
+
+ThreadGroup& GetThreadGroup() {
+  thread_local ThreadGroup group;
+  return group;
+}
+
+}  // namespace
+
+bool PerfCounters::Enable() {
+  ThreadGroup& group = GetThreadGroup();
+  Registry& registry = GetRegistry();
+  for (std::size_t event = 0; event < kEventCount; ++event) {
+    registry.available[event] = group.IsOpen(Event(event));
+  }
+  enabled = group.IsOpen();
+  return enabled;
+}
+
+void PerfCounters::Disable() noexcept { enabled = false; }
+
+bool PerfCounters::IsEnabled() noexcept { return enabled; }
+
+bool PerfCounters::IsAvailable(Event event) noexcept {
+  return GetRegistry().available[event];
+}
+
+const char* PerfCounters::GetEventName(Event event) noexcept {
+  static constexpr const char* kNames[kEventCount] = {
+      "task_clock_ns", "cycles", "instructions", "cache_misses",
+      "branch_misses"};
+  return kNames[event];
+}
+
+void PerfCounters::Reset() {
+  Registry& registry = GetRegistry();
+  std::lock_guard lock(registry.mtx);
+  ++registry.generation;
+  registry.next_index = 0;
+  auto& threads = registry.threads;
+  threads.erase(std::remove_if(threads.begin(), threads.end(),
+                               [](const auto& counters) {
+                                 return !counters->alive;
+                               }),
+                threads.end());
+}
+
+std::vector<PerfCounters::Sample> PerfCounters::GetSamples() {
+  Registry& registry = GetRegistry();
+  std::lock_guard registry_lock(registry.mtx);
+  std::map<std::pair<std::string, std::size_t>, Sample> merged;
+  for (const auto& counters : registry.threads) {
+    std::lock_guard lock(counters->mtx);
+    if (counters->generation != registry.generation) {
+      continue;
+    }
+    for (const auto& [phase, totals] : counters->totals) {
+      Sample& sample = merged[{phase, counters->index}];
+      sample.phase = phase;
+      sample.thread = counters->index;
+      sample.calls += totals.calls;
+      for (std::size_t event = 0; event < kEventCount; ++event) {
+        sample.values[event] += totals.values[event];
+      }
+    }
+  }
+
+  std::vector<Sample> samples;
+  for (auto& [key, sample] : merged) {
+    samples.push_back(std::move(sample));
+  }
+  return samples;
+}
+
+bool PerfPhase::Begin(const char* name) {
+  ThreadGroup& group = GetThreadGroup();
+  if (!group.IsOpen()) {
+    return false;
+  }
+  Values now = group.Read();
+  if (!group.stack.empty()) {
+    group.Charge(group.stack.back().first, group.stack.back().second, now, 0);
+  }
+  group.stack.emplace_back(name, now);
+  return true;
+}
+
+void PerfPhase::End() {
+  ThreadGroup& group = GetThreadGroup();
+  Values now = group.Read();
+  group.Charge(group.stack.back().first, group.stack.back().second, now, 1);
+  group.stack.pop_back();
+  if (!group.stack.empty()) {
+    group.stack.back().second = now;
+  }
+}
+
+}  // namespace s21
@@ -0,0 +1,101 @@
+#include "common/task_graph.h"
+
+#include <stdexcept>
+
+namespace s21 {
+
+TaskGraph::Node TaskGraph::AddTask(std::function<void()> task) {
+  vertices_.push_back(std::make_unique<Vertex>());
+  vertices_.back()->task = std::move(task);
+  return vertices_.size() - 1;
+}
+
+void TaskGraph::AddDependency(Node before, Node after) {
+  if (before >= vertices_.size() || after >= vertices_.size()) {
+    throw std::out_of_range("There is no such task in the graph");
+  } else if (before >= after) {
+    throw std::invalid_argument("A task can only depend on an earlier task");
+  }
+  vertices_[before]->successors.push_back(after);
+  ++vertices_[after]->dependencies;
+}
+
+void TaskGraph::Run(ThreadPool& pool) {
+  if (vertices_.empty()) {
+    return;
+  }
+
+  helped_ = pool.GetCurrentWorker() >= 0;
+  failed_ = false;
+  exception_ = nullptr;
+  unfinished_ = vertices_.size();
+  for (auto& vertex : vertices_) {
+    vertex->remaining = vertex->dependencies;
+  }
+  std::vector<Node> roots;
+  for (Node node = 0; node < vertices_.size(); ++node) {
+    if (vertices_[node]->dependencies == 0) {
+      roots.push_back(node);
+    }
+  }
+  pool.AddTasks(roots.size(), [this, &pool, &roots](std::size_t i) {
+    Execute(pool, roots[i]);
+  });
+
+  if (helped_) {
+    pool.Help([this] { return unfinished_ == 0; });
+  } else {
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait(lock, [this] { return unfinished_ == 0; });
+  }
+  if (exception_) {
+    std::rethrow_exception(exception_);
+  }
+}
+
+std::size_t TaskGraph::GetTaskCount() const noexcept {
+  return vertices_.size();
+}
+
+void TaskGraph::Schedule(ThreadPool& pool, Node node) {
+  pool.AddTasks(1, [this, &pool, node](std::size_t) { Execute(pool, node); });
+}
+
+void TaskGraph::Execute(ThreadPool& pool, Node node) {
+  if (!failed_) {
+    try {
+      vertices_[node]->task();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mtx_);
+      if (!exception_) {
+        exception_ = std::current_exception();
+      }
+      failed_ = true;
+    }
+  }
+  Finish(pool, node);
+}
+
+void TaskGraph::Finish(ThreadPool& pool, Node node) {
+  for (Node successor : vertices_[node]->successors) {
+    if (--vertices_[successor]->remaining == 0) {
+      Schedule(pool, successor);
+    }
+  }
+  if (helped_) {
+    // The graph may be gone as soon as the count reaches zero; the waiting
+    // worker checks it under the pool's mutex.
+    if (--unfinished_ == 0) {
+      pool.Wake();
+    }
+    return;
+  }
+  // Decrement under the lock: Run() may return, and the graph be destroyed,
+  // as soon as it sees zero.
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (--unfinished_ == 0) {
+    cv_.notify_all();
+  }
+}
+
+}  // namespace s21
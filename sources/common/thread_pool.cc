@@ -1,33 +1,174 @@
 #include "common/thread_pool.h"
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <set>
+#include <sstream>
 
 namespace s21 {
 
-ThreadPool::ThreadPool(std::size_t num_of_threads) {
-  for (std::size_t i = 0; i < num_of_threads; ++i) {
-    threads.emplace_back([this] {
-      while (true) {
-        std::function<void()> task;
+namespace {
+
+// The CPUs the process may run on, grouped by NUMA node; a single group if
+// the kernel does not expose the nodes.
+std::vector<std::vector<unsigned>> GetCpusByNode() {
+  std::set<unsigned> allowed;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        allowed.insert(cpu);
+      }
+    }
+  }
+#endif
+  if (allowed.empty()) {
+    for (unsigned cpu = 0; cpu < std::thread::hardware_concurrency(); ++cpu) {
+      allowed.insert(cpu);
+    }
+  }
+
+  // node<N>/cpulist holds ranges such as "0-7,16-23".
+  std::vector<std::pair<unsigned, std::vector<unsigned>>> nodes;
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator(
+           "/sys/devices/system/node", error)) {
+    std::string name = entry.path().filename().string();
+    if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+        !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+      continue;
+    }
+    std::ifstream file(entry.path() / "cpulist");
+    std::string range;
+    std::vector<unsigned> cpus;
+    while (std::getline(file, range, ',')) {
+      unsigned first = 0;
+      unsigned last = 0;
+      char dash = 0;
+      std::istringstream stream(range);
+      if (!(stream >> first)) {
+        continue;
+      } else if (!(stream >> dash >> last)) {
+        last = first;
+      }
+      for (unsigned cpu = first; cpu <= last; ++cpu) {
+        if (allowed.count(cpu)) {
+          cpus.push_back(cpu);
+        }
+      }
+    }
+    if (!cpus.empty()) {
+      nodes.emplace_back(std::stoul(name.substr(4)), std::move(cpus));
+    }
+  }
+  std::sort(nodes.begin(), nodes.end());
 
-        {
-          std::unique_lock<std::mutex> lock(mtx);
-          cv.wait(lock, [this] { return !tasks.empty() || stop; });
+  std::vector<std::vector<unsigned>> groups;
+  for (auto& node : nodes) {
+    groups.push_back(std::move(node.second));
+  }
+  if (groups.empty()) {
+    groups.emplace_back(allowed.begin(), allowed.end());
+  }
+  return groups;
+}
 
-          if (stop && tasks.empty()) {
-            return;
-          }
+std::vector<int> PlaceWorkers(std::size_t count,
+                              const ThreadPool::Placement& placement) {
+  using Affinity = ThreadPool::Affinity;
+  std::vector<int> cpus(count, -1);
+  if (placement.affinity == Affinity::kNone) {
+    return cpus;
+  }
 
-          task = std::move(tasks.front());
-          tasks.pop_front();
+  auto nodes = GetCpusByNode();
+  std::vector<unsigned> order;
+  if (placement.affinity == Affinity::kExplicit) {
+    if (placement.cpus.empty()) {
+      throw std::invalid_argument("The CPU list is empty");
+    }
+    for (unsigned cpu : placement.cpus) {
+      bool allowed = std::any_of(
+          nodes.begin(), nodes.end(), [cpu](const auto& node) {
+            return std::find(node.begin(), node.end(), cpu) != node.end();
+          });
+      if (!allowed) {
+        throw std::invalid_argument("The CPU is not available");
+      }
+    }
+    order = placement.cpus;
+  } else if (placement.affinity == Affinity::kCompact) {
+    for (const auto& node : nodes) {
+      order.insert(order.end(), node.begin(), node.end());
+    }
+  } else {
+    std::size_t longest = 0;
+    for (const auto& node : nodes) {
+      longest = std::max(longest, node.size());
+    }
+    for (std::size_t i = 0; i < longest; ++i) {
+      for (const auto& node : nodes) {
+        if (i < node.size()) {
+          order.push_back(node[i]);
         }
+      }
+    }
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    cpus[i] = int(order[i % order.size()]);
+  }
+  return cpus;
+}
+
+#ifdef S21_THREAD_POOL_STATS
+std::size_t GetBucket(std::uint64_t ns) {
+  std::size_t bucket = 0;
+  while (ns > 1 && bucket + 1 < ThreadPool::kHistogramBuckets) {
+    ns >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+#endif
+
+}  // namespace
 
-        task();
-        std::lock_guard<std::mutex> lock(mtx);
-        --task_count;
-        cv_join.notify_one();
+ThreadPool::ThreadPool(std::size_t num_of_threads)
+    : ThreadPool(num_of_threads, Placement()) {}
+
+ThreadPool::ThreadPool(std::size_t num_of_threads,
+                       const Placement& placement) {
+  if (num_of_threads == 0) {
+    throw std::invalid_argument(
+        "The number of threads must be greater than or equal to 1");
+  }
+
+  auto cpus = PlaceWorkers(num_of_threads, placement);
+  for (std::size_t i = 0; i < num_of_threads; ++i) {
+    workers.push_back(std::make_unique<Worker>());
+  }
+  for (std::size_t i = 0; i < num_of_threads; ++i) {
+    workers[i]->thread = std::thread([this, i] { Run(i); });
+#ifdef __linux__
+    // A worker that could not be pinned floats and reports -1.
+    if (cpus[i] >= 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpus[i], &set);
+      if (pthread_setaffinity_np(workers[i]->thread.native_handle(),
+                                 sizeof(set), &set) == 0) {
+        workers[i]->cpu = cpus[i];
       }
-    });
+    }
+#endif
   }
 }
 
@@ -39,14 +180,397 @@ ThreadPool::~ThreadPool() {
 
   cv.notify_all();
 
-  for (std::thread& thread : threads) {
-    thread.join();
+  for (auto& worker : workers) {
+    worker->thread.join();
   }
 }
 
+ThreadPool& ThreadPool::Shared() {
+  static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u));
+  return pool;
+}
+
 void ThreadPool::Join() {
-  std::unique_lock<std::mutex> lock(mtx);
-  cv_join.wait(lock, [this] { return task_count == 0 || stop; });
+  auto lock = Lock(mtx);
+  cv_join.wait(lock, [this] { return unfinished == 0; });
+}
+
+std::size_t ThreadPool::GetThreadCount() const noexcept {
+  return workers.size();
+}
+
+int ThreadPool::GetWorkerCpu(std::size_t index) const noexcept {
+  return index < workers.size() ? workers[index]->cpu : -1;
+}
+
+int ThreadPool::GetCurrentWorker() const noexcept {
+  return current_pool == this ? int(current_index) : -1;
+}
+
+void ThreadPool::Submit(Task* task) { Submit(&task, 1); }
+
+void ThreadPool::Submit(Task* const* tasks, std::size_t count) {
+  if (count == 0) {
+    return;
+  } else if (stop) {
+    for (std::size_t i = 0; i < count; ++i) {
+      if (tasks[i]->owned) {
+        delete tasks[i];
+      }
+    }
+    throw std::runtime_error("AddTask on stopped ThreadPool");
+  }
+
+#ifdef S21_THREAD_POOL_STATS
+  std::uint64_t now_ns = Now();
+  for (std::size_t i = 0; i < count; ++i) {
+    tasks[i]->enqueued_ns = now_ns;
+  }
+#endif
+  unfinished += count;
+  pending += count;
+
+  if (current_pool == this) {
+    for (std::size_t i = 0; i < count; ++i) {
+      workers[current_index]->deque.Push(tasks[i]);
+    }
+  } else {
+    // Task i goes to inbox first + i, as if submitted one by one, but each
+    // inbox is locked once.
+    std::size_t first = next_inbox.fetch_add(count, std::memory_order_relaxed);
+    std::size_t inboxes = std::min(count, workers.size());
+    for (std::size_t offset = 0; offset < inboxes; ++offset) {
+      Worker& worker = *workers[(first + offset) % workers.size()];
+      auto lock = Lock(worker.inbox_mtx);
+      for (std::size_t i = offset; i < count; i += workers.size()) {
+        worker.inbox.push_back(tasks[i]);
+        ++worker.inbox_size;
+      }
+    }
+  }
+
+  if (sleepers > 0) {
+    auto lock = Lock(mtx);
+    if (count == 1) {
+      cv.notify_one();
+    } else {
+      cv.notify_all();
+    }
+  }
+}
+
+void ThreadPool::SubmitPinned(Task* const* tasks, std::size_t count) {
+  if (stop) {
+    throw std::runtime_error("AddTask on stopped ThreadPool");
+  }
+#ifdef S21_THREAD_POOL_STATS
+  std::uint64_t now_ns = Now();
+  for (std::size_t i = 0; i < count; ++i) {
+    tasks[i]->enqueued_ns = now_ns;
+  }
+#endif
+  // Not counted in pending, which only covers tasks any worker may take.
+  unfinished += count;
+  for (std::size_t i = 0; i < count; ++i) {
+    auto lock = Lock(workers[i]->inbox_mtx);
+    workers[i]->pinned.push_back(tasks[i]);
+    ++workers[i]->pinned_size;
+  }
+  auto lock = Lock(mtx);
+  cv.notify_all();
+}
+
+void ThreadPool::Fail(Loop& loop) {
+  std::lock_guard<std::mutex> lock(loop.mtx);
+  if (!loop.exception) {
+    loop.exception = std::current_exception();
+  }
+  loop.failed = true;
+}
+
+void ThreadPool::Finish(Loop& loop) {
+  if (loop.helped) {
+    // The loop may be gone as soon as the count reaches zero; the waiting
+    // worker checks it under mtx.
+    if (--loop.unfinished == 0) {
+      Wake();
+    }
+    return;
+  }
+  // Decrement under the lock: Wait() may return, and the loop be destroyed,
+  // as soon as it sees zero.
+  std::lock_guard<std::mutex> lock(loop.mtx);
+  if (--loop.unfinished == 0) {
+    loop.cv.notify_all();
+  }
+}
+
+void ThreadPool::Wait(Loop& loop) {
+  if (loop.helped) {
+    Help([&loop] { return loop.unfinished == 0; });
+    return;
+  }
+  std::unique_lock<std::mutex> lock(loop.mtx);
+  loop.cv.wait(lock, [&loop] { return loop.unfinished == 0; });
+}
+
+void ThreadPool::Help(const std::function<bool()>& done) {
+  // Parked like an idle worker, so that tasks submitted meanwhile, or pinned
+  // to this worker, still wake it.
+  Worker& self = *workers[current_index];
+  while (!done()) {
+    if (Task* task = FindTask(current_index)) {
+      Execute(task, current_index);
+      continue;
+    }
+
+    auto lock = Lock(mtx);
+    ++sleepers;
+#ifdef S21_THREAD_POOL_STATS
+    std::uint64_t begin_ns = Now();
+#endif
+    cv.wait(lock, [this, &self, &done] {
+      return done() || pending > 0 || self.pinned_size > 0;
+    });
+#ifdef S21_THREAD_POOL_STATS
+    std::uint64_t end_ns = Now();
+    self.counters.wait_ns += end_ns - begin_ns;
+    Record(self, "wait", begin_ns, end_ns);
+#endif
+    --sleepers;
+  }
+}
+
+void ThreadPool::Wake() {
+  auto lock = Lock(mtx);
+  cv.notify_all();
+}
+
+void ThreadPool::Run(std::size_t index) {
+  current_pool = this;
+  current_index = index;
+  Worker& self = *workers[index];
+
+  while (true) {
+    if (Task* task = FindTask(index)) {
+      Execute(task, index);
+      continue;
+    }
+
+    auto lock = Lock(mtx);
+    ++sleepers;
+#ifdef S21_THREAD_POOL_STATS
+    std::uint64_t begin_ns = Now();
+#endif
+    cv.wait(lock, [this, &self] {
+      return pending > 0 || self.pinned_size > 0 || stop;
+    });
+#ifdef S21_THREAD_POOL_STATS
+    std::uint64_t end_ns = Now();
+    workers[index]->counters.wait_ns += end_ns - begin_ns;
+    Record(*workers[index], "wait", begin_ns, end_ns);
+#endif
+    --sleepers;
+
+    if (stop && pending == 0 && self.pinned_size == 0) {
+      return;
+    }
+  }
+}
+
+ThreadPool::Task* ThreadPool::FindTask(std::size_t index) {
+  Worker& self = *workers[index];
+  if (Task* task = TakePinned(self)) {
+    return task;
+  }
+
+  Task* task = nullptr;
+  if (!self.deque.Pop(task)) {
+    task = TakeFromInbox(self);
+  }
+  for (std::size_t offset = 1; !task && offset < workers.size(); ++offset) {
+    Worker& victim = *workers[(index + offset) % workers.size()];
+    if (!victim.deque.Steal(task)) {
+      task = TakeFromInbox(victim);
+    }
+#ifdef S21_THREAD_POOL_STATS
+    if (task) {
+      ++self.counters.steals;
+    }
+#endif
+  }
+
+  if (task) {
+    --pending;
+  }
+  return task;
+}
+
+ThreadPool::Task* ThreadPool::TakeFromInbox(Worker& worker) {
+  if (worker.inbox_size.load(std::memory_order_relaxed) == 0) {
+    return nullptr;
+  }
+
+  auto lock = Lock(worker.inbox_mtx);
+  if (worker.inbox.empty()) {
+    return nullptr;
+  }
+  Task* task = worker.inbox.front();
+  worker.inbox.pop_front();
+  --worker.inbox_size;
+
+  return task;
+}
+
+ThreadPool::Task* ThreadPool::TakePinned(Worker& worker) {
+  if (worker.pinned_size.load(std::memory_order_relaxed) == 0) {
+    return nullptr;
+  }
+
+  auto lock = Lock(worker.inbox_mtx);
+  if (worker.pinned.empty()) {
+    return nullptr;
+  }
+  Task* task = worker.pinned.front();
+  worker.pinned.pop_front();
+  --worker.pinned_size;
+
+  return task;
+}
+
+void ThreadPool::Execute(Task* task, std::size_t index) {
+  // A ParallelFor() task may be gone as soon as its function returns.
+  std::unique_ptr<Task> owned(task->owned ? task : nullptr);
+#ifdef S21_THREAD_POOL_STATS
+  Counters& counters = workers[index]->counters;
+  std::uint64_t begin_ns = Now();
+  std::uint64_t latency_ns = begin_ns - task->enqueued_ns;
+  task->function();
+  std::uint64_t end_ns = Now();
+  ++counters.tasks;
+  counters.latency_ns += latency_ns;
+  counters.busy_ns += end_ns - begin_ns;
+  ++counters.latency_histogram[GetBucket(latency_ns)];
+  ++counters.run_time_histogram[GetBucket(end_ns - begin_ns)];
+  Record(*workers[index], "task", begin_ns, end_ns);
+#else
+  (void)index;
+  task->function();
+#endif
+
+  if (--unfinished == 0) {
+    auto lock = Lock(mtx);
+    cv_join.notify_all();
+  }
+}
+
+std::unique_lock<std::mutex> ThreadPool::Lock(std::mutex& mutex) {
+#ifdef S21_THREAD_POOL_STATS
+  ++lock_acquisitions;
+  std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    std::uint64_t begin_ns = Now();
+    lock.lock();
+    ++lock_contentions;
+    lock_wait_ns += Now() - begin_ns;
+  }
+  return lock;
+#else
+  return std::unique_lock<std::mutex>(mutex);
+#endif
+}
+
+ThreadPool::Stats ThreadPool::GetStats() const {
+  Stats stats;
+#ifdef S21_THREAD_POOL_STATS
+  stats.enabled = true;
+  for (const auto& worker : workers) {
+    const Counters& counters = worker->counters;
+    stats.workers.push_back({counters.tasks, counters.steals, counters.wait_ns,
+                             counters.busy_ns, counters.latency_ns});
+    for (std::size_t i = 0; i < kHistogramBuckets; ++i) {
+      stats.latency_histogram[i] += counters.latency_histogram[i];
+      stats.run_time_histogram[i] += counters.run_time_histogram[i];
+    }
+  }
+  stats.lock_acquisitions = lock_acquisitions;
+  stats.lock_contentions = lock_contentions;
+  stats.lock_wait_ns = lock_wait_ns;
+#endif
+  return stats;
+}
+
+void ThreadPool::ResetStats() {
+#ifdef S21_THREAD_POOL_STATS
+  for (auto& worker : workers) {
+    Counters& counters = worker->counters;
+    for (auto* counter : {&counters.tasks, &counters.steals, &counters.wait_ns,
+                          &counters.busy_ns, &counters.latency_ns}) {
+      *counter = 0;
+    }
+    for (std::size_t i = 0; i < kHistogramBuckets; ++i) {
+      counters.latency_histogram[i] = 0;
+      counters.run_time_histogram[i] = 0;
+    }
+    std::lock_guard<std::mutex> lock(counters.trace_mtx);
+    counters.trace.clear();
+  }
+  lock_acquisitions = 0;
+  lock_contentions = 0;
+  lock_wait_ns = 0;
+#endif
+}
+
+void ThreadPool::SetTracing([[maybe_unused]] bool enabled) {
+#ifdef S21_THREAD_POOL_STATS
+  tracing = enabled;
+#endif
+}
+
+void ThreadPool::WriteTrace(std::ostream& os) const {
+  os << "{\"traceEvents\": [";
+#ifdef S21_THREAD_POOL_STATS
+  const char* separator = "\n";
+  for (std::size_t index = 0; index < workers.size(); ++index) {
+    os << separator << "{\"name\": \"thread_name\", \"ph\": \"M\", "
+       << "\"pid\": 0, \"tid\": " << index
+       << ", \"args\": {\"name\": \"worker " << index << "\"}}";
+    separator = ",\n";
+
+    const Counters& counters = workers[index]->counters;
+    std::lock_guard<std::mutex> lock(counters.trace_mtx);
+    for (const TraceEvent& event : counters.trace) {
+      // Timestamps are in microseconds.
+      os << separator << "{\"name\": \"" << event.name
+         << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << index
+         << ", \"ts\": " << event.begin_ns / 1000 << '.'
+         << event.begin_ns / 100 % 10 << ", \"dur\": "
+         << event.duration_ns / 1000 << '.' << event.duration_ns / 100 % 10
+         << '}';
+    }
+  }
+#endif
+  os << "\n], \"displayTimeUnit\": \"ns\"}\n";
+}
+
+#ifdef S21_THREAD_POOL_STATS
+std::uint64_t ThreadPool::Now() const noexcept {
+  return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           clock::now() - epoch)
+                           .count());
+}
+
+void ThreadPool::Record(Worker& worker, const char* name,
+                        std::uint64_t begin_ns, std::uint64_t end_ns) {
+  if (!tracing.load(std::memory_order_relaxed)) {
+    return;
+  }
+  Counters& counters = worker.counters;
+  std::lock_guard<std::mutex> lock(counters.trace_mtx);
+  if (counters.trace.size() < kMaxTraceEvents) {
+    counters.trace.push_back({name, begin_ns, end_ns - begin_ns});
+  }
 }
+#endif
 
 }  // namespace s21
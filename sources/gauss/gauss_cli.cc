@@ -72,13 +72,18 @@ unsigned GetChoice() {
 void RunAlgorithmNTimes(std::size_t n, s21::Matrix<double>& A,
                         std::vector<double>& B) {
   s21::Gauss gauss(A, B);
+  s21::BlockedGauss blocked_gauss(A, B);
   s21::ParallelGauss parallel_gauss(A, B);
   s21::Timer g_timer(n);
+  s21::Timer bg_timer(n);
   s21::Timer pg_timer(n);
   auto g_result = g_timer.MarkTime([&]() { return gauss.Solve(); });
+  auto bg_result = bg_timer.MarkTime([&]() { return blocked_gauss.Solve(); });
   auto pg_result = pg_timer.MarkTime([&]() { return parallel_gauss.Solve(); });
 
   std::cout << "\tGauss time\t\t\t" << g_timer.GetTime() << "ms" << std::endl;
+  std::cout << "\tBlocked Gauss time\t" << bg_timer.GetTime() << "ms"
+            << std::endl;
   std::cout << "\tParallel Gauss time\t" << pg_timer.GetTime() << "ms"
             << std::endl;
   std::cout << "\tDo you want to see the results of the algorithm? (y/n)"
@@ -95,6 +100,12 @@ void RunAlgorithmNTimes(std::size_t n, s21::Matrix<double>& A,
       std::cout << i << " ";
     }
     std::cout << std::endl;
+    std::cout << "\n\n\n"
+              << "Blocked Gauss:" << std::endl;
+    for (auto& i : bg_result) {
+      std::cout << i << " ";
+    }
+    std::cout << std::endl;
     std::cout << "\n\n\n"
               << "Parallel Gauss:" << std::endl;
     for (auto& i : pg_result) {
@@ -0,0 +1,435 @@
+#include "gauss/lu_factorization.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+#include "common/perf_counters.h"
+#include "common/task_graph.h"
+
+namespace s21 {
+
+LuFactorization::LuFactorization(const Matrix<double> &A) {
+  if (!Factorize(A)) {
+    throw std::runtime_error("The matrix is singular");
+  }
+}
+
+bool LuFactorization::Factorize(const Matrix<double> &A) {
+  Reset(A);
+  std::size_t blocks = GetBlockCount();
+
+  for (std::size_t k = 0; k < blocks; ++k) {
+    if (!FactorizePanel(k)) {
+      Clear();
+      return false;
+    }
+    for (std::size_t j = k + 1; j < blocks; ++j) {
+      UpdateBlockColumn(k, j);
+    }
+    ReleasePanel(k);
+  }
+  for (std::size_t k = 0; k + 1 < blocks; ++k) {
+    SwapLeftColumns(k);
+  }
+  packed_l_.clear();
+
+  return true;
+}
+
+bool LuFactorization::Factorize(const Matrix<double> &A, ThreadPool &pool) {
+  Reset(A);
+  std::size_t blocks = GetBlockCount();
+  std::atomic<bool> singular{false};
+  TaskGraph graph;
+  std::vector<TaskGraph::Node> panels(blocks);
+  std::vector<TaskGraph::Node> updates(blocks);
+  // The trailing updates of each step still to run.
+  std::vector<std::atomic<std::size_t>> remaining(blocks);
+
+  // updates[j] holds the latest task writing block column j.
+  for (std::size_t k = 0; k < blocks; ++k) {
+    panels[k] = graph.AddTask([this, &singular, k] {
+      if (!singular && !FactorizePanel(k)) {
+        singular = true;
+      }
+    });
+    if (k > 0) {
+      graph.AddDependency(updates[k], panels[k]);
+    }
+    remaining[k] = blocks - k - 1;
+    for (std::size_t j = k + 1; j < blocks; ++j) {
+      TaskGraph::Node update =
+          graph.AddTask([this, &singular, &remaining, k, j] {
+            if (!singular) {
+              UpdateBlockColumn(k, j);
+            }
+            if (--remaining[k] == 0) {
+              ReleasePanel(k);
+            }
+          });
+      graph.AddDependency(panels[k], update);
+      if (k > 0) {
+        graph.AddDependency(updates[j], update);
+      }
+      updates[j] = update;
+    }
+  }
+  // Nothing writes block column k after its panel, so its rows can be
+  // permuted as soon as the last pivot is known.
+  for (std::size_t k = 0; k + 1 < blocks; ++k) {
+    TaskGraph::Node swap = graph.AddTask([this, &singular, k] {
+      if (!singular) {
+        SwapLeftColumns(k);
+      }
+    });
+    graph.AddDependency(panels[blocks - 1], swap);
+  }
+  graph.Run(pool);
+  packed_l_.clear();
+
+  if (singular) {
+    Clear();
+    return false;
+  }
+  return true;
+}
+
+bool LuFactorization::IsFactorized() const noexcept {
+  return !pivots_.empty();
+}
+
+std::size_t LuFactorization::GetSize() const noexcept {
+  return pivots_.size();
+}
+
+std::vector<double> LuFactorization::Solve(
+    const std::vector<double> &b) const {
+  CheckRightHandSide(b.size());
+  PerfPhase phase("lu/solve");
+
+  std::size_t n = GetSize();
+  std::vector<double> X = b;
+
+  for (std::size_t i = 0; i < n; ++i) {
+    std::swap(X[i], X[pivots_[i]]);
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    const double *row = &LU_(i, 0);
+    for (std::size_t j = 0; j < i; ++j) {
+      X[i] -= row[j] * X[j];
+    }
+  }
+  for (std::size_t i = n; i-- > 0;) {
+    const double *row = &LU_(i, 0);
+    for (std::size_t j = i + 1; j < n; ++j) {
+      X[i] -= row[j] * X[j];
+    }
+    X[i] /= row[i];
+  }
+
+  return X;
+}
+
+std::vector<double> LuFactorization::Solve(const std::vector<double> &b,
+                                           ThreadPool &pool) const {
+  CheckRightHandSide(b.size());
+
+  std::size_t n = GetSize();
+  std::size_t blocks = (n + kSolveBlockSize - 1) / kSolveBlockSize;
+  std::vector<double> X = b;
+  TaskGraph graph;
+
+  // last[i] is the latest task writing block i of X; each task waits for the
+  // previous writer of its block and for the solved block it reads. Every
+  // forward task precedes the last forward diagonal block, so the backward
+  // sweep never overwrites a block that is still being read.
+  TaskGraph::Node permute = graph.AddTask([this, &X, n] {
+    for (std::size_t i = 0; i < n; ++i) {
+      std::swap(X[i], X[pivots_[i]]);
+    }
+  });
+  std::vector<TaskGraph::Node> last(blocks, permute);
+
+  for (bool upper : {false, true}) {
+    for (std::size_t step = 0; step < blocks; ++step) {
+      std::size_t solved = upper ? blocks - 1 - step : step;
+      TaskGraph::Node diagonal = graph.AddTask([this, &X, upper, solved] {
+        SolveDiagonalBlock(upper, solved, X);
+      });
+      graph.AddDependency(last[solved], diagonal);
+      last[solved] = diagonal;
+
+      for (std::size_t rest = step + 1; rest < blocks; ++rest) {
+        std::size_t block = upper ? blocks - 1 - rest : rest;
+        TaskGraph::Node update = graph.AddTask([this, &X, solved, block] {
+          UpdateSolutionBlock(solved, block, X);
+        });
+        graph.AddDependency(diagonal, update);
+        graph.AddDependency(last[block], update);
+        last[block] = update;
+      }
+    }
+  }
+  graph.Run(pool);
+
+  return X;
+}
+
+Matrix<double> LuFactorization::Solve(const Matrix<double> &B) const {
+  CheckRightHandSide(B.GetRows());
+  PerfPhase phase("lu/solve");
+
+  std::size_t n = GetSize();
+  std::size_t m = B.GetCols();
+  Matrix<double> X = B;
+
+  for (std::size_t i = 0; i < n; ++i) {
+    if (pivots_[i] != i) {
+      X.SwapRows(i, pivots_[i]);
+    }
+  }
+  if (m == 0) {
+    return X;
+  }
+  // Row-oriented substitution: every step is an axpy over all m right-hand
+  // sides, so one pass over the factors serves the whole batch.
+  for (std::size_t i = 0; i < n; ++i) {
+    const double *row = &LU_(i, 0);
+    double *x_i = &X(i, 0);
+    for (std::size_t j = 0; j < i; ++j) {
+      const double *x_j = &X(j, 0);
+      for (std::size_t c = 0; c < m; ++c) {
+        x_i[c] -= row[j] * x_j[c];
+      }
+    }
+  }
+  for (std::size_t i = n; i-- > 0;) {
+    const double *row = &LU_(i, 0);
+    double *x_i = &X(i, 0);
+    for (std::size_t j = i + 1; j < n; ++j) {
+      const double *x_j = &X(j, 0);
+      for (std::size_t c = 0; c < m; ++c) {
+        x_i[c] -= row[j] * x_j[c];
+      }
+    }
+    for (std::size_t c = 0; c < m; ++c) {
+      x_i[c] /= row[i];
+    }
+  }
+
+  return X;
+}
+
+void LuFactorization::CheckRightHandSide(std::size_t rows) const {
+  if (!IsFactorized()) {
+    throw std::runtime_error("The matrix has not been factorized");
+  } else if (rows != GetSize()) {
+    throw std::invalid_argument("The matrix is incomplete");
+  }
+}
+
+void LuFactorization::SolveDiagonalBlock(bool upper, std::size_t block,
+                                         std::vector<double> &X) const {
+  PerfPhase phase("lu/solve");
+  std::size_t begin = block * kSolveBlockSize;
+  std::size_t end = std::min(begin + kSolveBlockSize, GetSize());
+
+  if (!upper) {
+    for (std::size_t i = begin; i < end; ++i) {
+      const double *row = &LU_(i, 0);
+      for (std::size_t j = begin; j < i; ++j) {
+        X[i] -= row[j] * X[j];
+      }
+    }
+    return;
+  }
+  for (std::size_t i = end; i-- > begin;) {
+    const double *row = &LU_(i, 0);
+    for (std::size_t j = i + 1; j < end; ++j) {
+      X[i] -= row[j] * X[j];
+    }
+    X[i] /= row[i];
+  }
+}
+
+void LuFactorization::UpdateSolutionBlock(std::size_t solved,
+                                          std::size_t block,
+                                          std::vector<double> &X) const {
+  PerfPhase phase("lu/solve");
+  std::size_t n = GetSize();
+  std::size_t begin = block * kSolveBlockSize;
+  std::size_t end = std::min(begin + kSolveBlockSize, n);
+  std::size_t solved_begin = solved * kSolveBlockSize;
+  std::size_t solved_end = std::min(solved_begin + kSolveBlockSize, n);
+
+  for (std::size_t i = begin; i < end; ++i) {
+    const double *row = &LU_(i, 0);
+    double sum = 0;
+    for (std::size_t j = solved_begin; j < solved_end; ++j) {
+      sum += row[j] * X[j];
+    }
+    X[i] -= sum;
+  }
+}
+
+void LuFactorization::Reset(const Matrix<double> &A) {
+  if (A.GetRows() == 0 || A.GetCols() == 0) {
+    throw std::invalid_argument("The matrix cannot have a size of 0");
+  } else if (A.GetRows() != A.GetCols()) {
+    throw std::invalid_argument("The matrix must be square");
+  }
+
+  LU_ = A;
+  pivots_.assign(A.GetRows(), 0);
+  packed_l_.assign(GetBlockCount(), {});
+}
+
+void LuFactorization::Clear() {
+  LU_ = Matrix<double>();
+  pivots_.clear();
+  packed_l_.clear();
+}
+
+std::size_t LuFactorization::GetBlockCount() const noexcept {
+  return (LU_.GetRows() + kBlockSize - 1) / kBlockSize;
+}
+
+std::size_t LuFactorization::GetBlockWidth(std::size_t block) const noexcept {
+  return std::min(kBlockSize, LU_.GetRows() - block * kBlockSize);
+}
+
+bool LuFactorization::FactorizePanel(std::size_t block) {
+  PerfPhase phase("lu/panel");
+  std::size_t n = LU_.GetRows();
+  std::size_t k = block * kBlockSize;
+  std::size_t kb = GetBlockWidth(block);
+
+  for (std::size_t j = k; j < k + kb; ++j) {
+    std::size_t pivot = j;
+    for (std::size_t i = j + 1; i < n; ++i) {
+      if (std::abs(LU_(i, j)) > std::abs(LU_(pivot, j))) {
+        pivot = i;
+      }
+    }
+    if (std::abs(LU_(pivot, j)) < 1e-7) {
+      return false;
+    }
+    pivots_[j] = pivot;
+    if (pivot != j) {
+      std::swap_ranges(&LU_(j, k), &LU_(j, k) + kb, &LU_(pivot, k));
+    }
+
+    const double *pivot_row = &LU_(j, 0);
+    for (std::size_t i = j + 1; i < n; ++i) {
+      double *row = &LU_(i, 0);
+      row[j] /= pivot_row[j];
+      for (std::size_t c = j + 1; c < k + kb; ++c) {
+        row[c] -= row[j] * pivot_row[c];
+      }
+    }
+  }
+
+  std::size_t begin = k + kb;
+  std::vector<double> &packed = packed_l_[block];
+  packed.assign(((n - begin + kMr - 1) / kMr) * kMr * kb, 0);
+  for (std::size_t i = begin; i < n; ++i) {
+    const double *l_row = &LU_(i, k);
+    std::size_t b = (i - begin) / kMr;
+    for (std::size_t p = 0; p < kb; ++p) {
+      packed[(b * kb + p) * kMr + (i - begin) % kMr] = l_row[p];
+    }
+  }
+
+  return true;
+}
+
+void LuFactorization::UpdateBlockColumn(std::size_t step, std::size_t block) {
+  PerfPhase phase("lu/update");
+  std::size_t n = LU_.GetRows();
+  std::size_t k = step * kBlockSize;
+  std::size_t kb = GetBlockWidth(step);
+  std::size_t column = block * kBlockSize;
+  std::size_t width = GetBlockWidth(block);
+
+  for (std::size_t j = k; j < k + kb; ++j) {
+    if (pivots_[j] != j) {
+      std::swap_ranges(&LU_(j, column), &LU_(j, column) + width,
+                       &LU_(pivots_[j], column));
+    }
+  }
+  for (std::size_t j = k; j < k + kb; ++j) {
+    const double *pivot_row = &LU_(j, column);
+    for (std::size_t i = j + 1; i < k + kb; ++i) {
+      double l = LU_(i, j);
+      double *row = &LU_(i, column);
+      for (std::size_t c = 0; c < width; ++c) {
+        row[c] -= l * pivot_row[c];
+      }
+    }
+  }
+
+  std::size_t begin = k + kb;
+  std::size_t panels = (width + kNr - 1) / kNr;
+  std::size_t row_blocks = (n - begin + kMr - 1) / kMr;
+  std::vector<double> packed_u(panels * kb * kNr, 0);
+  const std::vector<double> &packed_l = packed_l_[step];
+
+  for (std::size_t p = 0; p < kb; ++p) {
+    const double *u_row = &LU_(k + p, column);
+    for (std::size_t c = 0; c < width; ++c) {
+      packed_u[((c / kNr) * kb + p) * kNr + c % kNr] = u_row[c];
+    }
+  }
+  for (std::size_t b = 0; b < row_blocks; ++b) {
+    std::size_t row = begin + b * kMr;
+    std::size_t mr = std::min(kMr, n - row);
+    for (std::size_t q = 0; q < panels; ++q) {
+      std::size_t nr = std::min(kNr, width - q * kNr);
+      Tile c{};
+
+      MicroKernel(kb, &packed_l[b * kb * kMr], &packed_u[q * kb * kNr], c);
+      for (std::size_t r = 0; r < mr; ++r) {
+        double *out = &LU_(row + r, column + q * kNr);
+        for (std::size_t j = 0; j < nr; ++j) {
+          out[j] -= c[r][j];
+        }
+      }
+    }
+  }
+}
+
+void LuFactorization::SwapLeftColumns(std::size_t block) {
+  PerfPhase phase("lu/swap");
+  std::size_t n = LU_.GetRows();
+  std::size_t column = block * kBlockSize;
+  std::size_t width = GetBlockWidth(block);
+
+  for (std::size_t j = column + width; j < n; ++j) {
+    if (pivots_[j] != j) {
+      std::swap_ranges(&LU_(j, column), &LU_(j, column) + width,
+                       &LU_(pivots_[j], column));
+    }
+  }
+}
+
+void LuFactorization::ReleasePanel(std::size_t block) {
+  std::vector<double>().swap(packed_l_[block]);
+}
+
+void LuFactorization::MicroKernel(std::size_t depth, const double *l,
+                                  const double *u, Tile &c) {
+  Tile acc{};
+
+  for (std::size_t p = 0; p < depth; ++p, l += kMr, u += kNr) {
+    for (std::size_t r = 0; r < kMr; ++r) {
+      for (std::size_t j = 0; j < kNr; ++j) {
+        acc[r][j] += l[r] * u[j];
+      }
+    }
+  }
+  std::copy(&acc[0][0], &acc[0][0] + kMr * kNr, &c[0][0]);
+}
+
+}  // namespace s21
@@ -1,12 +1,26 @@
 #include "grape/grape.h"
 
+#include <algorithm>
+
+#include "common/perf_counters.h"
+#include "grape/winograd_kernel.h"
+
 namespace s21 {
 
 Grape::Grape(const Matrix<double>& m1, const Matrix<double>& m2) {
   LoadMatrices(m1, m2);
 }
 
+Grape::Grape(const MatrixView<double>& m1, const MatrixView<double>& m2) {
+  LoadMatrices(m1, m2);
+}
+
 void Grape::LoadMatrices(const Matrix<double>& m1, const Matrix<double>& m2) {
+  LoadMatrices(MatrixView<double>(m1), MatrixView<double>(m2));
+}
+
+void Grape::LoadMatrices(const MatrixView<double>& m1,
+                         const MatrixView<double>& m2) {
   if (m1.GetRows() == 0 || m1.GetCols() == 0 || m2.GetRows() == 0 ||
       m2.GetCols() == 0) {
     throw std::invalid_argument("The matrix cannot have a size of 0");
@@ -21,39 +35,11 @@ void Grape::LoadMatrices(const Matrix<double>& m1, const Matrix<double>& m2) {
 }
 
 Matrix<double> Grape::Mul() {
-  std::vector<double> row_factor(m1_.GetRows(), 0);
-  std::vector<double> column_factor(m2_.GetCols(), 0);
   Matrix<double> result(m1_.GetRows(), m2_.GetCols());
+  WinogradKernel kernel(m1_, m2_);
 
-  for (std::size_t i = 0; i < m1_.GetRows(); ++i) {
-    for (std::size_t j = 0; j < m1_.GetCols() / 2; ++j) {
-      row_factor[i] += m1_[i][2 * j] * m1_[i][2 * j + 1];
-    }
-  }
-
-  for (std::size_t i = 0; i < m2_.GetCols(); ++i) {
-    for (std::size_t j = 0; j < m2_.GetRows() / 2; ++j) {
-      column_factor[i] += m2_[2 * j][i] * m2_[2 * j + 1][i];
-    }
-  }
-
-  for (std::size_t i = 0; i < result.GetRows(); ++i) {
-    for (std::size_t j = 0; j < result.GetCols(); ++j) {
-      result[i][j] = -row_factor[i] - column_factor[j];
-      for (std::size_t k = 0; k < m1_.GetCols() / 2; ++k) {
-        result[i][j] += (m1_[i][2 * k] + m2_[2 * k + 1][j]) *
-                        (m1_[i][2 * k + 1] + m2_[2 * k][j]);
-      }
-    }
-  }
-
-  if (m1_.GetCols() % 2 != 0) {
-    for (std::size_t i = 0; i < result.GetRows(); ++i) {
-      for (std::size_t j = 0; j < result.GetCols(); ++j) {
-        result[i][j] += m1_[i][m1_.GetCols() - 1] * m2_[m1_.GetCols() - 1][j];
-      }
-    }
-  }
+  kernel.PackPanels(0, kernel.GetPanelCount());
+  kernel.Compute(0, result.GetRows(), result);
 
   return result;
 }
@@ -63,8 +49,18 @@ ClassicParallelGrape::ClassicParallelGrape(const Matrix<double>& m1,
   LoadMatrices(m1, m2);
 }
 
+ClassicParallelGrape::ClassicParallelGrape(const MatrixView<double>& m1,
+                                           const MatrixView<double>& m2) {
+  LoadMatrices(m1, m2);
+}
+
 void ClassicParallelGrape::LoadMatrices(const Matrix<double>& m1,
                                         const Matrix<double>& m2) {
+  LoadMatrices(MatrixView<double>(m1), MatrixView<double>(m2));
+}
+
+void ClassicParallelGrape::LoadMatrices(const MatrixView<double>& m1,
+                                        const MatrixView<double>& m2) {
   if (m1.GetRows() == 0 || m1.GetCols() == 0 || m2.GetRows() == 0 ||
       m2.GetCols() == 0) {
     throw std::invalid_argument("The matrix cannot have a size of 0");
@@ -74,71 +70,46 @@ void ClassicParallelGrape::LoadMatrices(const Matrix<double>& m1,
         "number of rows in the second");
   }
 
-  m1_ = Matrix<std::atomic<double>>(m1.GetRows(), m1.GetCols());
-  m2_ = Matrix<std::atomic<double>>(m2.GetRows(), m2.GetCols());
-  X_ = Matrix<std::atomic<double>>(m1_.GetRows(), m2_.GetCols());
-  row_factor_ = std::vector<std::atomic<double>>(m1.GetRows());
-  column_factor_ = std::vector<std::atomic<double>>(m2.GetCols());
-
-  for (std::size_t i = 0; i < m1.GetRows(); ++i) {
-    for (std::size_t j = 0; j < m1.GetCols(); ++j) {
-      m1_[i][j].store(m1[i][j]);
-    }
-  }
-  for (std::size_t i = 0; i < m2.GetRows(); ++i) {
-    for (std::size_t j = 0; j < m2.GetCols(); ++j) {
-      m2_[i][j].store(m2[i][j]);
-    }
-  }
+  m1_ = m1;
+  m2_ = m2;
 }
 
-Matrix<std::atomic<double>>& ClassicParallelGrape::Mul(
-    std::size_t number_of_threads) {
+Matrix<double> ClassicParallelGrape::Mul(std::size_t number_of_threads) {
   ThreadPool pool(number_of_threads);
+  return Mul(pool);
+}
 
-  for (std::size_t i = 0; i < m1_.GetRows(); ++i) {
-    pool.AddTask([this, i]() {
-      for (std::size_t j = 0; j < m1_.GetCols() / 2; ++j) {
-        row_factor_[i] = row_factor_[i] + m1_[i][2 * j] * m1_[i][2 * j + 1];
-      }
-    });
-  }
-
-  for (std::size_t i = 0; i < m2_.GetCols(); ++i) {
-    pool.AddTask([this, i]() {
-      for (std::size_t j = 0; j < m2_.GetRows() / 2; ++j) {
-        column_factor_[i] =
-            column_factor_[i] + m2_[2 * j][i] * m2_[2 * j + 1][i];
-      }
-    });
-  }
-
-  pool.Join();
-
-  for (std::size_t i = 0; i < X_.GetRows(); ++i) {
-    pool.AddTask([this, i]() {
-      for (std::size_t j = 0; j < X_.GetCols(); ++j) {
-        X_[i][j] = -row_factor_[i] - column_factor_[j];
-        for (std::size_t k = 0; k < m1_.GetCols() / 2; ++k) {
-          X_[i][j] = X_[i][j] + (m1_[i][2 * k] + m2_[2 * k + 1][j]) *
-                                    (m1_[i][2 * k + 1] + m2_[2 * k][j]);
-        }
-      }
-    });
-  }
-
-  pool.Join();
-
-  if (m1_.GetCols() % 2 != 0) {
-    for (std::size_t i = 0; i < X_.GetRows(); ++i) {
-      for (std::size_t j = 0; j < X_.GetCols(); ++j) {
-        X_[i][j] =
-            X_[i][j] + m1_[i][m1_.GetCols() - 1] * m2_[m1_.GetCols() - 1][j];
-      }
-    }
-  }
-
-  return X_;
+Matrix<double> ClassicParallelGrape::Mul(ThreadPool& pool) {
+  WinogradKernel kernel(m1_, m2_);
+  pool.ParallelFor(0, kernel.GetPanelCount(), 1,
+                   [&kernel](std::size_t first, std::size_t last) {
+                     kernel.PackPanels(first, last);
+                   });
+
+  // On pinned workers every block of rows is computed by the worker that
+  // zeroed it. Floating workers gain nothing from that, so the rows are
+  // handed out on demand, in chunks of at most one row block of the kernel.
+  std::size_t rows = m1_.GetRows();
+  if (pool.GetWorkerCpu(0) >= 0) {
+    Matrix<double> result(rows, m2_.GetCols(), pool);
+    result.ForEachRowBlock(
+        pool, [&kernel, &result](std::size_t first, std::size_t last) {
+          kernel.Compute(first, last, result);
+        });
+    return result;
+  }
+
+  Matrix<double> result(rows, m2_.GetCols());
+  std::size_t grain =
+      std::clamp(rows / (4 * pool.GetThreadCount()), WinogradKernel::kMr,
+                 WinogradKernel::kMc);
+  pool.ParallelFor(
+      0, rows, grain,
+      [&kernel, &result](std::size_t first, std::size_t last) {
+        kernel.Compute(first, last, result);
+      },
+      ThreadPool::Schedule::kDynamic);
+  return result;
 }
 
 PipelineParallelGrape::PipelineParallelGrape(const Matrix<double>& m1,
@@ -146,8 +117,18 @@ PipelineParallelGrape::PipelineParallelGrape(const Matrix<double>& m1,
   LoadMatrices(m1, m2);
 }
 
+PipelineParallelGrape::PipelineParallelGrape(const MatrixView<double>& m1,
+                                             const MatrixView<double>& m2) {
+  LoadMatrices(m1, m2);
+}
+
 void PipelineParallelGrape::LoadMatrices(const Matrix<double>& m1,
                                          const Matrix<double>& m2) {
+  LoadMatrices(MatrixView<double>(m1), MatrixView<double>(m2));
+}
+
+void PipelineParallelGrape::LoadMatrices(const MatrixView<double>& m1,
+                                         const MatrixView<double>& m2) {
   if (m1.GetRows() == 0 || m1.GetCols() == 0 || m2.GetRows() == 0 ||
       m2.GetCols() == 0) {
     throw std::invalid_argument("The matrix cannot have a size of 0");
@@ -157,25 +138,12 @@ void PipelineParallelGrape::LoadMatrices(const Matrix<double>& m1,
         "number of rows in the second");
   }
 
-  m1_ = Matrix<std::atomic<double>>(m1.GetRows(), m1.GetCols());
-  m2_ = Matrix<std::atomic<double>>(m2.GetRows(), m2.GetCols());
-  X_ = Matrix<std::atomic<double>>(m1_.GetRows(), m2_.GetCols());
-  row_factor_ = std::vector<std::atomic<double>>(m1.GetRows());
-  column_factor_ = std::vector<std::atomic<double>>(m2.GetCols());
-  col_factor_flag = std::vector<bool>(column_factor_.size());
-  for (std::size_t i = 0; i < m1.GetRows(); ++i) {
-    for (std::size_t j = 0; j < m1.GetCols(); ++j) {
-      m1_[i][j].store(m1[i][j]);
-    }
-  }
-  for (std::size_t i = 0; i < m2.GetRows(); ++i) {
-    for (std::size_t j = 0; j < m2.GetCols(); ++j) {
-      m2_[i][j].store(m2[i][j]);
-    }
-  }
+  m1_ = m1;
+  m2_ = m2;
 }
 
-double PipelineParallelGrape::CalculateRowFactor(std::size_t row) {
+double PipelineParallelGrape::CalculateRowFactor(std::size_t row) const {
+  PerfPhase phase("grape/factors");
   double row_factor = 0;
 
   for (std::size_t k = 0; k < m1_.GetCols() / 2; ++k) {
@@ -185,115 +153,63 @@ double PipelineParallelGrape::CalculateRowFactor(std::size_t row) {
   return row_factor;
 }
 
-void PipelineParallelGrape::TryCalculateColumnFactor(std::size_t column) {
-  std::lock_guard<std::mutex> lock(mtx);
-  if (column_factor_[column] == 0) {
-    for (std::size_t k = 0; k < m2_.GetRows() / 2; ++k) {
-      column_factor_[column] =
-          column_factor_[column] + m2_[2 * k][column] * m2_[2 * k + 1][column];
-    }
+double PipelineParallelGrape::CalculateColumnFactor(std::size_t column) const {
+  PerfPhase phase("grape/factors");
+  double column_factor = 0;
+
+  for (std::size_t k = 0; k < m2_.GetRows() / 2; ++k) {
+    column_factor += m2_[2 * k][column] * m2_[2 * k + 1][column];
   }
+
+  return column_factor;
 }
 
-void PipelineParallelGrape::CalculateOneMatrixElement(
-    std::size_t row, std::size_t column, const double& row_factor) {
-  X_[row][column] = -row_factor - column_factor_[column];
+double PipelineParallelGrape::CalculateOneMatrixElement(
+    std::size_t row, std::size_t column, double row_factor,
+    double column_factor) const {
+  double element = -row_factor - column_factor;
+
   for (std::size_t k = 0; k < m1_.GetCols() / 2; ++k) {
-    X_[row][column] =
-        X_[row][column] + (m1_[row][2 * k] + m2_[2 * k + 1][column]) *
-                              (m1_[row][2 * k + 1] + m2_[2 * k][column]);
+    element += (m1_[row][2 * k] + m2_[2 * k + 1][column]) *
+               (m1_[row][2 * k + 1] + m2_[2 * k][column]);
   }
-}
-
-void PipelineParallelGrape::TryCalculateOddMatrix(std::size_t row,
-                                                  std::size_t column) {
   if (m1_.GetCols() % 2 != 0) {
-    X_[row][column] = X_[row][column] + m1_[row][m1_.GetCols() - 1] *
-                                            m2_[m1_.GetCols() - 1][column];
+    element += m1_[row][m1_.GetCols() - 1] * m2_[m1_.GetCols() - 1][column];
   }
+
+  return element;
 }
 
-Matrix<std::atomic<double>>& PipelineParallelGrape::Mul(
-    std::size_t number_of_threads) {
+Matrix<double> PipelineParallelGrape::Mul(std::size_t number_of_threads) {
   ThreadPool pool(number_of_threads);
+  return Mul(pool);
+}
 
-  for (std::size_t i = 0; i < X_.GetRows(); ++i) {
-    pool.AddTask([this, i]() {
-      double row_factor = CalculateRowFactor(i);
-      for (std::size_t j = 0; j < X_.GetCols(); ++j) {
-        TryCalculateColumnFactor(j);
-        CalculateOneMatrixElement(i, j, row_factor);
-        TryCalculateOddMatrix(i, j);
-      }
-    });
-  }
+Matrix<double> PipelineParallelGrape::Mul(ThreadPool& pool) {
+  Matrix<double> result(m1_.GetRows(), m2_.GetCols());
+  std::vector<double> column_factor(m2_.GetCols());
+
+  pool.ParallelFor(0, column_factor.size(), 1,
+                   [this, &column_factor](std::size_t first, std::size_t last) {
+                     for (std::size_t j = first; j < last; ++j) {
+                       column_factor[j] = CalculateColumnFactor(j);
+                     }
+                   });
+  pool.ParallelFor(
+      0, result.GetRows(), 1,
+      [this, &result, &column_factor](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+          PerfPhase phase("grape/product");
+          double row_factor = CalculateRowFactor(i);
+          for (std::size_t j = 0; j < result.GetCols(); ++j) {
+            result[i][j] =
+                CalculateOneMatrixElement(i, j, row_factor, column_factor[j]);
+          }
+        }
+      },
+      ThreadPool::Schedule::kDynamic);
 
-  //    pool.AddTask([this, &pool]
-  //    {
-  //        for (int j = 0; j < m1_.GetCols() / 2; ++j)
-  //        {
-  //            row_factor_[0] = row_factor_[0] + m1_[0][2 * j] * m1_[0][2 * j +
-  //            1];
-  //        }
-  //        for (int j = 0; j < X_.GetCols(); ++j)
-  //        {
-  //            std::unique_lock<std::mutex> lk(mtx);
-  //            cv.wait(lk, [this, j] { return col_factor_flag[j]; });
-  //            pool.AddTask([this, j]()
-  //            {
-  //                X_[0][j] = -row_factor_[0] - column_factor_[j];
-  //                for (int k = 0; k < m1_.GetCols() / 2; ++k)
-  //                {
-  //                    X_[0][j] = X_[0][j] + (m1_[0][2 * k] + m2_[2 * k +
-  //                    1][j]) * (m1_[0][2 * k + 1] + m2_[2 * k][j]);
-  //                }
-  //            });
-  //        }
-  //    });
-  //
-  //    for (int i = 0; i < m2_.GetCols(); ++i)
-  //    {
-  //        pool.AddTask([this, i]()
-  //        {
-  //            for (int j = 0; j < m2_.GetRows() / 2; ++j)
-  //            {
-  //                column_factor_[i] = column_factor_[i] + m2_[2 * j][i] *
-  //                m2_[2 * j + 1][i];
-  //            }
-  //            std::unique_lock<std::mutex> lk(mtx);
-  //            column_factor_[i] = true;
-  //            lk.unlock();
-  //            cv.notify_one();
-  //        });
-  //    }
-  //
-  //    for (int i = 1; i < m1_.GetRows(); ++i)
-  //    {
-  //        pool.AddTask([this, &pool, i]()
-  //        {
-  //            for (int j = 0; j < m1_.GetCols() / 2; ++j)
-  //            {
-  //                row_factor_[i] = row_factor_[i] + m1_[i][2 * j] * m1_[i][2 *
-  //                j + 1];
-  //            }
-  //            pool.AddTask([this, i]()
-  //            {
-  //                for (int j = 0; j < X_.GetCols(); ++j)
-  //                {
-  //                    X_[i][j] = -row_factor_[i] - column_factor_[j];
-  //                    for (int k = 0; k < m1_.GetCols() / 2; ++k)
-  //                    {
-  //                        X_[i][j] = X_[i][j] + (m1_[i][2 * k] + m2_[2 * k +
-  //                        1][j]) * (m1_[i][2 * k + 1] + m2_[2 * k][j]);
-  //                    }
-  //                }
-  //            });
-  //        });
-  //    }
-  //
-  //    pool.Join();
-
-  return X_;
+  return result;
 }
 
 }  // namespace s21
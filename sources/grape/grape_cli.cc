@@ -7,7 +7,8 @@
 bool ProcessMenu();
 unsigned GetChoice();
 void RunAlgorithmNTimes(std::size_t n, std::size_t number_of_threads,
-                        s21::Matrix<double>& m1, s21::Matrix<double>& m2);
+                        const s21::MatrixView<double>& m1,
+                        const s21::MatrixView<double>& m2);
 
 int main() {
   while (ProcessMenu()) {
@@ -17,8 +18,9 @@ int main() {
 }
 
 bool ProcessMenu() {
-  static s21::Matrix<double> m1;
-  static s21::Matrix<double> m2;
+  // Binary files are multiplied straight from their mappings.
+  static s21::MatrixView<double> m1;
+  static s21::MatrixView<double> m2;
   static long iterations;
   static std::size_t number_of_threads;
   static std::size_t x1;
@@ -33,19 +35,26 @@ bool ProcessMenu() {
         std::cout << "\tEnter the path and file name of the first matrix"
                   << std::endl;
         std::cin >> filename;
-        m1.LoadMatrixFromFile(filename);
+        m1 = s21::MatrixView<double>::Load(filename);
         std::cout << "\tEnter the path and file name of the second matrix"
                   << std::endl;
         std::cin >> filename;
-        m2.LoadMatrixFromFile(filename);
+        m2 = s21::MatrixView<double>::Load(filename);
         break;
-      case 2:
+      case 2: {
+        s21::Matrix<double> first;
+        s21::Matrix<double> second;
         std::cout << "\tEnter the first matrix" << std::endl;
-        m1.ReadFull();
+        first.ReadFull();
         std::cout << "\tEnter the second matrix" << std::endl;
-        m2.ReadFull();
+        second.ReadFull();
+        m1 = s21::MatrixView<double>(std::move(first));
+        m2 = s21::MatrixView<double>(std::move(second));
         break;
-      case 3:
+      }
+      case 3: {
+        s21::Matrix<double> first;
+        s21::Matrix<double> second;
         x1 = 0;
         y1 = 0;
         x2 = 0;
@@ -55,20 +64,23 @@ bool ProcessMenu() {
           std::cin.clear();
           std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         }
-        m1.Generate(x1, y1);
+        first.Generate(x1, y1);
         std::cout << "\tEnter the dimension of the second matrix" << std::endl;
         while (!(std::cin >> x2 >> y2)) {
           std::cin.clear();
           std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         }
-        m2.Generate(x2, y2);
+        second.Generate(x2, y2);
         std::cout << "\tGenerated matrices:" << std::endl;
         std::cout << std::endl;
-        m1.PrintFull();
+        first.PrintFull();
         std::cout << std::endl;
-        m2.PrintFull();
+        second.PrintFull();
         std::cout << std::endl;
+        m1 = s21::MatrixView<double>(std::move(first));
+        m2 = s21::MatrixView<double>(std::move(second));
         break;
+      }
       case 4:
         number_of_threads = 0;
         std::cout << "\tEnter the number of threads:" << std::endl;
@@ -119,22 +131,21 @@ unsigned GetChoice() {
 }
 
 void RunAlgorithmNTimes(std::size_t n, std::size_t number_of_threads,
-                        s21::Matrix<double>& m1, s21::Matrix<double>& m2) {
+                        const s21::MatrixView<double>& m1,
+                        const s21::MatrixView<double>& m2) {
   s21::Grape grape(m1, m2);
   s21::ClassicParallelGrape classic_parallel_grape(m1, m2);
   s21::PipelineParallelGrape pipeline_parallel_grape(m1, m2);
+  // Started before the timers, so that no run pays for spawning threads.
+  s21::ThreadPool pool(number_of_threads);
   s21::Timer g_timer(n);
   s21::Timer cpg_timer(n);
   s21::Timer ppg_timer(n);
   auto g_result = g_timer.MarkTime([&]() { return grape.Mul(); });
-  auto cpg_result = cpg_timer.MarkTime([&]() {
-    return ConvertAtomicMatrixToDouble(
-        classic_parallel_grape.Mul(number_of_threads));
-  });
-  auto ppg_result = ppg_timer.MarkTime([&]() {
-    return ConvertAtomicMatrixToDouble(
-        pipeline_parallel_grape.Mul(number_of_threads));
-  });
+  auto cpg_result =
+      cpg_timer.MarkTime([&]() { return classic_parallel_grape.Mul(pool); });
+  auto ppg_result =
+      ppg_timer.MarkTime([&]() { return pipeline_parallel_grape.Mul(pool); });
 
   std::cout << "\tGrape time\t\t\t" << g_timer.GetTime() << "ms" << std::endl;
   std::cout << "\tClassic Parallel Grape time\t" << cpg_timer.GetTime() << "ms"
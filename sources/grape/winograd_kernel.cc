@@ -0,0 +1,154 @@
+#include "grape/winograd_kernel.h"
+
+#include <algorithm>
+
+#include "common/perf_counters.h"
+
+namespace s21 {
+
+WinogradKernel::WinogradKernel(const MatrixView<double>& m1,
+                               const MatrixView<double>& m2)
+    : m1_(m1),
+      m2_(m2),
+      pairs_(m1.GetCols() / 2),
+      panel_stride_(2 * kNr * pairs_),
+      packed_m2_(GetPanelCount() * panel_stride_, 0),
+      column_factor_(m2.GetCols(), 0) {}
+
+std::size_t WinogradKernel::GetPanelCount() const noexcept {
+  return (m2_.GetCols() + kNr - 1) / kNr;
+}
+
+void WinogradKernel::PackPanels(std::size_t panel_begin,
+                                std::size_t panel_end) {
+  {
+    PerfPhase phase("grape/pack");
+    for (std::size_t p = panel_begin; p < panel_end; ++p) {
+      std::size_t column = p * kNr;
+      std::size_t nr = std::min(kNr, m2_.GetCols() - column);
+      double* panel = packed_m2_.data() + p * panel_stride_;
+
+      for (std::size_t k = 0; k < pairs_; ++k, panel += 2 * kNr) {
+        for (std::size_t jj = 0; jj < nr; ++jj) {
+          panel[jj] = m2_[2 * k + 1][column + jj];
+          panel[kNr + jj] = m2_[2 * k][column + jj];
+        }
+      }
+    }
+  }
+
+  PerfPhase phase("grape/factors");
+  for (std::size_t p = panel_begin; p < panel_end; ++p) {
+    std::size_t column = p * kNr;
+    std::size_t nr = std::min(kNr, m2_.GetCols() - column);
+    const double* panel = packed_m2_.data() + p * panel_stride_;
+
+    for (std::size_t k = 0; k < pairs_; ++k, panel += 2 * kNr) {
+      for (std::size_t jj = 0; jj < nr; ++jj) {
+        column_factor_[column + jj] += panel[kNr + jj] * panel[jj];
+      }
+    }
+  }
+}
+
+void WinogradKernel::Compute(std::size_t row_begin, std::size_t row_end,
+                             Matrix<double>& result) const {
+  PerfPhase phase("grape/product");
+  std::size_t cols = m2_.GetCols();
+  std::size_t panels = GetPanelCount();
+  std::vector<double> packed_rows(
+      ((kMc + kMr - 1) / kMr) * kMr * 2 * std::min(kKc, pairs_), 0);
+
+  for (std::size_t ic = row_begin; ic < row_end; ic += kMc) {
+    std::size_t mc = std::min(kMc, row_end - ic);
+
+    double row_factors[kMc] = {};
+    {
+      PerfPhase factors_phase("grape/factors");
+      for (std::size_t i = 0; i < mc; ++i) {
+        for (std::size_t k = 0; k < pairs_; ++k) {
+          row_factors[i] += m1_[ic + i][2 * k] * m1_[ic + i][2 * k + 1];
+        }
+      }
+    }
+    for (std::size_t i = 0; i < mc; ++i) {
+      for (std::size_t j = 0; j < cols; ++j) {
+        result[ic + i][j] = -row_factors[i] - column_factor_[j];
+      }
+    }
+
+    for (std::size_t pc = 0; pc < pairs_; pc += kKc) {
+      std::size_t kc = std::min(kKc, pairs_ - pc);
+      PackRows(ic, mc, pc, kc, packed_rows.data());
+
+      for (std::size_t p = 0; p < panels; ++p) {
+        const double* b = packed_m2_.data() + p * panel_stride_ + pc * 2 * kNr;
+        std::size_t column = p * kNr;
+        std::size_t nr = std::min(kNr, cols - column);
+
+        for (std::size_t ir = 0; ir < mc; ir += kMr) {
+          std::size_t mr = std::min(kMr, mc - ir);
+          const double* a = packed_rows.data() + ir * 2 * kc;
+          Tile c{};
+
+          for (std::size_t ii = 0; ii < mr; ++ii) {
+            for (std::size_t jj = 0; jj < nr; ++jj) {
+              c[ii][jj] = result[ic + ir + ii][column + jj];
+            }
+          }
+          MicroKernel(kc, a, b, c);
+          for (std::size_t ii = 0; ii < mr; ++ii) {
+            for (std::size_t jj = 0; jj < nr; ++jj) {
+              result[ic + ir + ii][column + jj] = c[ii][jj];
+            }
+          }
+        }
+      }
+    }
+
+    if (m1_.GetCols() % 2 != 0) {
+      std::size_t last = m1_.GetCols() - 1;
+      for (std::size_t i = ic; i < ic + mc; ++i) {
+        for (std::size_t j = 0; j < cols; ++j) {
+          result[i][j] += m1_[i][last] * m2_[last][j];
+        }
+      }
+    }
+  }
+}
+
+void WinogradKernel::PackRows(std::size_t row_begin, std::size_t rows,
+                              std::size_t pair_begin, std::size_t pairs,
+                              double* packed) const {
+  for (std::size_t ir = 0; ir < rows; ir += kMr) {
+    std::size_t mr = std::min(kMr, rows - ir);
+
+    for (std::size_t k = 0; k < pairs; ++k, packed += 2 * kMr) {
+      std::size_t column = 2 * (pair_begin + k);
+      for (std::size_t ii = 0; ii < kMr; ++ii) {
+        bool inside = ii < mr;
+        packed[ii] = inside ? m1_[row_begin + ir + ii][column] : 0;
+        packed[kMr + ii] = inside ? m1_[row_begin + ir + ii][column + 1] : 0;
+      }
+    }
+  }
+}
+
+void WinogradKernel::MicroKernel(std::size_t pairs, const double* a,
+                                 const double* b, Tile& c) {
+  Tile acc;
+  std::copy(&c[0][0], &c[0][0] + kMr * kNr, &acc[0][0]);
+
+  for (std::size_t k = 0; k < pairs; ++k, a += 2 * kMr, b += 2 * kNr) {
+    for (std::size_t ii = 0; ii < kMr; ++ii) {
+      double a_even = a[ii];
+      double a_odd = a[kMr + ii];
+      for (std::size_t jj = 0; jj < kNr; ++jj) {
+        acc[ii][jj] += (a_even + b[jj]) * (a_odd + b[kNr + jj]);
+      }
+    }
+  }
+  std::copy(&acc[0][0], &acc[0][0] + kMr * kNr, &c[0][0]);
+}
+
+}  // namespace s21
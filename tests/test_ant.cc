@@ -18,6 +18,499 @@ TEST_F(ANT, TSP_PARALLEL) {
   EXPECT_EQ(CalculateTheRouteDistance(tsp.vertices), tsp.distance);
 }
 
+TEST_F(ANT, TSP_SHARED_THREAD_POOL) {
+  ThreadPool pool(2);
+  graph.LoadGraphFromFile(File::kNonOrientedWeightedMatrix5x5);
+  ant.LoadGraph(graph);
+  for (unsigned i = 0; i < 3; ++i) {
+    Ant::TsmResult tsp = ant.Solve(pool);
+    EXPECT_TRUE(IsUnique(tsp.vertices));
+    EXPECT_EQ(CalculateTheRouteDistance(tsp.vertices), tsp.distance);
+  }
+}
+
+TEST_F(ANT, GRAPH_LAYOUT) {
+  graph.LoadGraphFromFile(File::kNonOrientedWeightedMatrix5x5);
+  EXPECT_EQ(graph.GetLayout(), Graph::Layout::kSymmetric);
+  EXPECT_EQ(graph.GetWeight(0, 2), 11u);
+  EXPECT_EQ(graph.GetWeight(2, 0), 11u);
+  AdjacencyMatrix adjacency_matrix = graph.GetAdjacencyMatrix();
+  EXPECT_EQ(adjacency_matrix[3][1], 10u);
+  EXPECT_EQ(adjacency_matrix[4][4], 0u);
+
+  graph.LoadGraphFromFile(File::kNonOrientedWeightedMatrix10x10);
+  EXPECT_FALSE(graph.IsComplete());
+
+  auto filename =
+      (std::filesystem::temp_directory_path() / "s21_oriented_graph.txt")
+          .string();
+  std::ofstream(filename) << "3 3\n0 1 2\n3 0 4\n2 4 0\n";
+  graph.LoadGraphFromFile(filename);
+  EXPECT_EQ(graph.GetLayout(), Graph::Layout::kFull);
+  EXPECT_EQ(graph.GetWeight(0, 1), 1u);
+  EXPECT_EQ(graph.GetWeight(1, 0), 3u);
+  // Symmetric but for the last row.
+  std::ofstream(filename) << "3 3\n0 1 2\n1 0 4\n2 5 0\n";
+  graph.LoadGraphFromFile(filename);
+  EXPECT_EQ(graph.GetLayout(), Graph::Layout::kFull);
+  EXPECT_EQ(graph.GetWeight(1, 2), 4u);
+  EXPECT_EQ(graph.GetWeight(2, 1), 5u);
+  EXPECT_EQ(graph.GetWeight(0, 2), 2u);
+  EXPECT_EQ(graph.GetWeight(1, 0), 1u);
+  // weight_max would read back as a missing edge.
+  std::ofstream(filename) << "2 2\n0 4294967294\n4294967295 0\n";
+  EXPECT_THROW(graph.LoadGraphFromFile(filename), std::invalid_argument);
+  std::filesystem::remove(filename);
+}
+
+TEST_F(ANT, BINARY_GRAPH) {
+  auto filename =
+      (std::filesystem::temp_directory_path() / "s21_binary_graph.bin")
+          .string();
+  graph.LoadGraphFromFile(File::kNonOrientedWeightedMatrix10x10);
+  AdjacencyMatrix expected = graph.GetAdjacencyMatrix();
+  graph.SaveGraphToBinaryFile(filename);
+  graph.LoadGraphFromFile(filename);
+  EXPECT_FALSE(graph.IsComplete());
+  EXPECT_TRUE(graph.GetAdjacencyMatrix() == expected);
+
+  graph.LoadTsplibFromFile(File::kTsplibBurma14);
+  expected = graph.GetAdjacencyMatrix();
+  graph.SaveGraphToBinaryFile(filename);
+  Graph copy;
+  copy.LoadGraphFromFile(filename);
+  graph = copy;
+  copy.LoadGraphFromFile(File::kNonOrientedWeightedMatrix5x5);
+  EXPECT_EQ(graph.GetLayout(), Graph::Layout::kSymmetric);
+  EXPECT_TRUE(graph.GetAdjacencyMatrix() == expected);
+  ant.LoadGraph(graph);
+  Ant::TsmResult tsp = ant.Solve(false);
+  EXPECT_TRUE(IsUnique(tsp.vertices));
+  EXPECT_EQ(CalculateTheRouteDistance(tsp.vertices), tsp.distance);
+
+  Matrix<std::uint32_t> matrix(2, 2, 1);
+  matrix.SaveMatrixToBinaryFile(filename);
+  // Not "Incorrect data format", as if it were a malformed text file.
+  try {
+    graph.LoadGraphFromFile(filename);
+    ADD_FAILURE();
+  } catch (const std::invalid_argument& error) {
+    EXPECT_STREQ(error.what(), "Binary matrix files are not graphs");
+  }
+  std::filesystem::remove(filename);
+}
+
+TEST_F(ANT, TSPLIB_GRAPH) {
+  graph.LoadTsplibFromFile(File::kTsplibEuc2d5);
+  EXPECT_EQ(graph.GetLayout(), Graph::Layout::kCoordinates);
+  ASSERT_EQ(graph.GetSize(), 5u);
+  EXPECT_TRUE(graph.IsComplete());
+  EXPECT_TRUE(graph.IsWeighted());
+  EXPECT_EQ(graph.GetWeight(0, 1), 5u);
+  EXPECT_EQ(graph.GetWeight(0, 2), 6u);
+  EXPECT_EQ(graph.GetWeight(1, 1), 0u);
+  EXPECT_EQ(graph.GetWeight(4, 2), 11u);
+
+  graph.LoadTsplibFromFile(File::kTsplibBurma14);
+  ASSERT_EQ(graph.GetSize(), 14u);
+  EXPECT_EQ(graph.GetWeight(0, 1), 153u);
+  EXPECT_EQ(graph.GetWeight(4, 0), 966u);
+  ant.LoadGraph(graph);
+  Ant::Options options;
+  options.local_search = Ant::LocalSearchMode::kAllAnts;
+  options.seed = 5;
+  ant.SetOptions(options);
+  Ant::TsmResult tsp = ant.Solve(false);
+  EXPECT_TRUE(IsUnique(tsp.vertices));
+  EXPECT_EQ(tsp.vertices.size(), 15u);
+  EXPECT_EQ(CalculateTheRouteDistance(tsp.vertices), tsp.distance);
+  EXPECT_GE(tsp.distance, 3323);
+
+  // The heuristic computed from the coordinates matches the one cached for
+  // stored weights.
+  auto binary =
+      (std::filesystem::temp_directory_path() / "s21_burma14.bin").string();
+  graph.SaveGraphToBinaryFile(binary);
+  Graph weights;
+  weights.LoadGraphFromFile(binary);
+  Ant cached;
+  cached.LoadGraph(weights);
+  cached.SetOptions(options);
+  Ant::TsmResult expected = cached.Solve(false);
+  EXPECT_EQ(tsp.vertices, expected.vertices);
+  EXPECT_EQ(tsp.history, expected.history);
+  std::filesystem::remove(binary);
+
+  EXPECT_ANY_THROW(
+      graph.LoadTsplibFromFile(File::kNonOrientedWeightedMatrix5x5));
+  EXPECT_FALSE(graph.IsLoaded());
+
+  // Other sections may come before the coordinates.
+  auto filename =
+      (std::filesystem::temp_directory_path() / "s21_sections.tsp").string();
+  std::ofstream(filename) << "NAME : sections\nDIMENSION : 2\n"
+                          << "DISPLAY_DATA_SECTION\n1 5 5\n2 6 6\n"
+                          << "FIXED_EDGES_SECTION\n1 2\n-1\n"
+                          << "EDGE_WEIGHT_TYPE : EUC_2D\n"
+                          << "NODE_COORD_SECTION\n1 0 0\n2 3 4\nEOF\n";
+  graph.LoadTsplibFromFile(filename);
+  EXPECT_EQ(graph.GetWeight(0, 1), 5u);
+  std::ofstream(filename) << "DIMENSION : 2\nEDGE_WEIGHT_TYPE : EUC_2D\nEOF\n";
+  EXPECT_THROW(graph.LoadTsplibFromFile(filename), std::invalid_argument);
+  std::ofstream(filename) << "DIMENSION : 2\nEDGE_WEIGHT_TYPE : EUC_2D\n"
+                          << "NODE_COORD_SECTION\n1 0 0\n2 0 4294967295\nEOF\n";
+  EXPECT_THROW(graph.LoadTsplibFromFile(filename), std::invalid_argument);
+  std::filesystem::remove(filename);
+}
+
+TEST_F(ANT, NEAREST_NEIGHBOURS) {
+  graph.LoadGraphFromFile(File::kNonOrientedWeightedMatrix5x5);
+  NeighbourLists neighbours(graph, 2);
+  ASSERT_EQ(neighbours.GetCount(), 2u);
+  EXPECT_EQ(neighbours.Get(0)[0], 4u);
+  EXPECT_EQ(neighbours.Get(0)[1], 1u);
+  EXPECT_EQ(neighbours.Get(2)[0], 1u);
+  EXPECT_EQ(NeighbourLists(graph, 100).GetCount(), 4u);
+}
+
+TEST_F(ANT, TSP_CANDIDATE_LISTS) {
+  graph.LoadGraphFromFile(File::kNonOrientedWeightedMatrix5x5);
+  ant.LoadGraph(graph);
+  Ant::Options options;
+  options.candidate_list_size = 2;
+  ant.SetOptions(options);
+  Ant::TsmResult tsp = ant.Solve(false);
+  EXPECT_TRUE(IsUnique(tsp.vertices));
+  EXPECT_EQ(CalculateTheRouteDistance(tsp.vertices), tsp.distance);
+
+  // The edges off the lists keep their trails apart from the candidates',
+  // and MMAS bounds them the same way.
+  options.variant = Ant::Variant::kMaxMin;
+  ant.SetOptions(options);
+  tsp = ant.Solve(false);
+  Matrix<double> pheromone = ant.GetPheromone();
+  ASSERT_EQ(pheromone.GetRows(), 5u);
+  ASSERT_EQ(pheromone.GetCols(), 5u);
+  double tau_max = 1.0 / (tsp.distance * options.evaporation_rate);
+  double p = std::pow(options.max_min_p_best, 1.0 / 5.0);
+  double tau_min = tau_max * (1.0 - p) / (1.5 * p);
+  for (std::size_t i = 0; i < 5; ++i) {
+    for (std::size_t j = 0; j < 5; ++j) {
+      if (i != j) {
+        EXPECT_GE(pheromone(i, j), tau_min * (1.0 - 1e-9));
+        EXPECT_LE(pheromone(i, j), tau_max * (1.0 + 1e-9));
+      }
+    }
+  }
+
+  // Most steps on a larger instance run out of candidates at some point.
+  auto filename =
+      (std::filesystem::temp_directory_path() / "s21_candidates.tsp").string();
+  {
+    Xoshiro256 generator(7);
+    std::ofstream file(filename);
+    file << "DIMENSION: 300\nEDGE_WEIGHT_TYPE: EUC_2D\nNODE_COORD_SECTION\n";
+    for (int i = 1; i <= 300; ++i) {
+      file << i << ' ' << generator.NextDouble() * 1000.0 << ' '
+           << generator.NextDouble() * 1000.0 << '\n';
+    }
+  }
+  graph.LoadTsplibFromFile(filename);
+  std::filesystem::remove(filename);
+  ant.LoadGraph(graph);
+  options = Ant::Options();
+  options.candidate_list_size = 8;
+  options.max_iterations = 10;
+  options.seed = 3;
+  ant.SetOptions(options);
+  ThreadPool pool(2);
+  tsp = ant.Solve(false);
+  EXPECT_TRUE(IsUnique(tsp.vertices));
+  EXPECT_EQ(tsp.vertices.size(), 301u);
+  EXPECT_EQ(CalculateTheRouteDistance(tsp.vertices), tsp.distance);
+  EXPECT_EQ(ant.Solve(pool).vertices, tsp.vertices);
+}
+
+TEST_F(ANT, TSP_SHARED_GRAPH) {
+  graph.LoadGraphFromFile(File::kNonOrientedWeightedMatrix5x5);
+  const Graph& shared = graph;
+  Ant other;
+  ant.LoadGraph(shared);
+  other.LoadGraph(shared);
+  Ant::Options options;
+  options.candidate_list_size = 2;
+  ant.SetOptions(options);
+  options.candidate_list_size = 3;
+  options.local_search = Ant::LocalSearchMode::kAllAnts;
+  other.SetOptions(options);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_TRUE(IsUnique(ant.Solve(false).vertices));
+    EXPECT_TRUE(IsUnique(other.Solve(false).vertices));
+  }
+}
+
+TEST_F(ANT, LOCAL_SEARCH) {
+  graph.LoadGraphFromFile(File::kNonOrientedWeightedMatrix5x5);
+  NeighbourLists neighbours(graph, 4);
+  LocalSearch local_search(graph, neighbours);
+  Ant::tour_t tour = {0, 2, 1, 4, 3};
+  EXPECT_TRUE(local_search.Improve(tour));
+
+  std::vector<size_type> route;
+  for (auto vertex : tour) {
+    route.push_back(vertex + 1);
+  }
+  route.push_back(route.front());
+  EXPECT_TRUE(IsUnique(route));
+  EXPECT_EQ(route.size(), 6u);
+  EXPECT_LT(CalculateTheRouteDistance(route), 30u);
+
+  // Or-opt moves segments across the end of the tour as well.
+  graph.LoadTsplibFromFile(File::kTsplibBurma14);
+  NeighbourLists burma_neighbours(graph, 6);
+  LocalSearch burma_search(graph, burma_neighbours);
+  auto length = [this](const Ant::tour_t& cities) {
+    size_type total = 0;
+    for (std::size_t i = 0; i < cities.size(); ++i) {
+      total += graph.GetWeight(cities[i], cities[(i + 1) % cities.size()]);
+    }
+    return total;
+  };
+  std::mt19937 generator(14);
+  for (int i = 0; i < 20; ++i) {
+    Ant::tour_t cities(graph.GetSize());
+    std::iota(cities.begin(), cities.end(), 0);
+    std::shuffle(cities.begin(), cities.end(), generator);
+    auto before = length(cities);
+    burma_search.Improve(cities);
+    EXPECT_LE(length(cities), before);
+    Ant::tour_t sorted = cities;
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t city = 0; city < sorted.size(); ++city) {
+      EXPECT_EQ(sorted[city], city);
+    }
+  }
+}
+
+TEST_F(ANT, TSP_LOCAL_SEARCH) {
+  ThreadPool pool(2);
+  graph.LoadGraphFromFile(File::kNonOrientedWeightedMatrix5x5);
+  ant.LoadGraph(graph);
+  Ant::Options options;
+  options.local_search = Ant::LocalSearchMode::kAllAnts;
+  ant.SetOptions(options);
+  Ant::TsmResult tsp = ant.Solve(pool);
+  EXPECT_TRUE(IsUnique(tsp.vertices));
+  EXPECT_EQ(CalculateTheRouteDistance(tsp.vertices), tsp.distance);
+  EXPECT_EQ(tsp.distance, 17);
+}
+
+TEST_F(ANT, TSP_VARIANTS) {
+  graph.LoadGraphFromFile(File::kNonOrientedWeightedMatrix5x5);
+  ant.LoadGraph(graph);
+  for (auto variant :
+       {Ant::Variant::kAntSystem, Ant::Variant::kElitist,
+        Ant::Variant::kRankBased, Ant::Variant::kMaxMin,
+        Ant::Variant::kAntColonySystem}) {
+    Ant::Options options;
+    options.variant = variant;
+    options.number_of_ants = 5;
+    options.max_iterations = 50;
+    ant.SetOptions(options);
+    Ant::TsmResult tsp = ant.Solve(false);
+    EXPECT_TRUE(IsUnique(tsp.vertices));
+    EXPECT_EQ(CalculateTheRouteDistance(tsp.vertices), tsp.distance);
+
+    // The largest trail: every ant's deposits add up in Ant System, while
+    // ACS moves a trail only towards 1 / best and MMAS clamps it to
+    // [tau_min, tau_max].
+    Matrix<double> pheromone = ant.GetPheromone();
+    double best_amount = 1.0 / tsp.distance;
+    double tau_max = best_amount / options.evaporation_rate;
+    double p = std::pow(options.max_min_p_best, 1.0 / 5.0);
+    double tau_min = tau_max * (1.0 - p) / (1.5 * p);
+    double highest = 0.0;
+    for (std::size_t i = 0; i < 5; ++i) {
+      for (std::size_t j = 0; j < 5; ++j) {
+        if (i == j) {
+          continue;
+        }
+        highest = std::max(highest, pheromone(i, j));
+        if (variant == Ant::Variant::kMaxMin) {
+          EXPECT_GE(pheromone(i, j), tau_min * (1.0 - 1e-9));
+          EXPECT_LE(pheromone(i, j), tau_max * (1.0 + 1e-9));
+        }
+      }
+    }
+    if (variant == Ant::Variant::kAntSystem) {
+      EXPECT_GT(highest, best_amount);
+    } else if (variant == Ant::Variant::kAntColonySystem) {
+      EXPECT_LE(highest, best_amount * (1.0 + 1e-9));
+    }
+  }
+}
+
+TEST_F(ANT, TSP_ACS_LOCAL_UPDATE) {
+  auto filename =
+      (std::filesystem::temp_directory_path() / "s21_acs.tsp").string();
+  {
+    Xoshiro256 generator(11);
+    std::ofstream file(filename);
+    file << "DIMENSION: 30\nEDGE_WEIGHT_TYPE: EUC_2D\nNODE_COORD_SECTION\n";
+    for (int i = 1; i <= 30; ++i) {
+      file << i << ' ' << generator.NextDouble() * 1000.0 << ' '
+           << generator.NextDouble() * 1000.0 << '\n';
+    }
+  }
+  graph.LoadTsplibFromFile(filename);
+  std::filesystem::remove(filename);
+  ant.LoadGraph(graph);
+
+  // Greedy ants that ignore distances follow the trails alone. Decaying an
+  // edge only after all of them had moved would send every ant along the
+  // first best tour forever; decaying it as it is crossed spreads them out.
+  Ant::Options options;
+  options.variant = Ant::Variant::kAntColonySystem;
+  options.acs_q0 = 1.0;
+  options.acs_local_evaporation = 1.0;
+  options.beta = 0.0;
+  options.max_iterations = 20;
+  options.seed = 1;
+  ThreadPool pool(2);
+  for (std::size_t candidates : {0, 8}) {
+    options.candidate_list_size = candidates;
+    ant.SetOptions(options);
+    Ant::TsmResult tsp = ant.Solve(false);
+    EXPECT_TRUE(IsUnique(tsp.vertices));
+    EXPECT_EQ(CalculateTheRouteDistance(tsp.vertices), tsp.distance);
+    EXPECT_LT(tsp.distance, tsp.history.front());
+    EXPECT_EQ(ant.Solve(pool).history, tsp.history);
+  }
+}
+
+TEST_F(ANT, TSP_ISLANDS) {
+  ThreadPool pool(2);
+  graph.LoadGraphFromFile(File::kNonOrientedWeightedMatrix5x5);
+  ant.LoadGraph(graph);
+  Ant::Options options;
+  options.colonies = 4;
+  options.migration_interval = 7;
+  options.max_iterations = 30;
+  ant.SetOptions(options);
+  for (bool parallel : {false, true}) {
+    Ant::TsmResult tsp = parallel ? ant.Solve(pool) : ant.Solve(false);
+    EXPECT_TRUE(IsUnique(tsp.vertices));
+    EXPECT_EQ(CalculateTheRouteDistance(tsp.vertices), tsp.distance);
+    EXPECT_EQ(tsp.iterations, 30u);
+    EXPECT_EQ(tsp.history.size(), tsp.iterations);
+    EXPECT_EQ(tsp.history.back(), tsp.distance);
+  }
+}
+
+TEST_F(ANT, TSP_SEED) {
+  ThreadPool pool(3);
+  graph.LoadGraphFromFile(File::kNonOrientedWeightedMatrix5x5);
+  ant.LoadGraph(graph);
+  Ant::Options options;
+  options.seed = 42;
+  options.max_iterations = 20;
+  options.colonies = 2;
+  options.migration_interval = 5;
+  ant.SetOptions(options);
+  Ant::TsmResult expected = ant.Solve(false);
+  EXPECT_EQ(expected.seed, 42u);
+  for (int i = 0; i < 3; ++i) {
+    Ant::TsmResult tsp = i % 2 ? ant.Solve(pool) : ant.Solve(false);
+    EXPECT_EQ(tsp.vertices, expected.vertices);
+    EXPECT_EQ(tsp.history, expected.history);
+  }
+
+  // The entropy that stops the run is summed the same way on any pool.
+  graph.LoadTsplibFromFile(File::kTsplibBurma14);
+  ant.LoadGraph(graph);
+  options.colonies = 1;
+  options.max_iterations = 1000;
+  options.min_entropy = 0.5;
+  ant.SetOptions(options);
+  expected = ant.Solve(false);
+  Ant::TsmResult tsp = ant.Solve(pool);
+  EXPECT_EQ(tsp.stop_reason, Ant::StopReason::kEntropy);
+  EXPECT_EQ(tsp.iterations, expected.iterations);
+  EXPECT_EQ(tsp.history, expected.history);
+
+  options.seed = 0;
+  ant.SetOptions(options);
+  EXPECT_NE(ant.Solve(false).seed, 0u);
+}
+
+TEST_F(ANT, TSP_DEADLINE) {
+  graph.LoadGraphFromFile(File::kNonOrientedWeightedMatrix5x5);
+  ant.LoadGraph(graph);
+  Ant::TsmResult tsp = ant.Solve(Ant::clock::now());
+  EXPECT_TRUE(IsUnique(tsp.vertices));
+  EXPECT_EQ(tsp.iterations, 1u);
+  EXPECT_EQ(tsp.stop_reason, Ant::StopReason::kDeadline);
+  ASSERT_EQ(tsp.history.size(), 1u);
+  EXPECT_EQ(tsp.history.back(), tsp.distance);
+}
+
+TEST_F(ANT, TSP_EARLY_STOP) {
+  graph.LoadGraphFromFile(File::kNonOrientedWeightedMatrix5x5);
+  ant.LoadGraph(graph);
+  Ant::Options options;
+  options.max_iterations = 1000;
+  options.stagnation_iterations = 20;
+  ant.SetOptions(options);
+  Ant::TsmResult tsp = ant.Solve(false);
+  EXPECT_EQ(tsp.stop_reason, Ant::StopReason::kStagnation);
+  EXPECT_LT(tsp.iterations, options.max_iterations);
+  EXPECT_EQ(tsp.history.size(), tsp.iterations);
+  EXPECT_TRUE(std::is_sorted(tsp.history.rbegin(), tsp.history.rend()));
+  EXPECT_EQ(tsp.history.back(), tsp.distance);
+
+  options.stagnation_iterations = 0;
+  options.min_entropy = 0.5;
+  ant.SetOptions(options);
+  tsp = ant.Solve(false);
+  EXPECT_EQ(tsp.stop_reason, Ant::StopReason::kEntropy);
+  EXPECT_LT(tsp.iterations, options.max_iterations);
+  EXPECT_TRUE(IsUnique(tsp.vertices));
+}
+
+TEST_F(ANT, TSP_INVALID_OPTIONS) {
+  Ant::Options options;
+  options.number_of_ants = 0;
+  EXPECT_ANY_THROW(ant.SetOptions(options));
+  options = Ant::Options();
+  options.alpha = -1.0;
+  EXPECT_ANY_THROW(ant.SetOptions(options));
+  options = Ant::Options();
+  options.beta = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_ANY_THROW(ant.SetOptions(options));
+  options.beta = std::numeric_limits<double>::infinity();
+  EXPECT_ANY_THROW(ant.SetOptions(options));
+  options = Ant::Options();
+  options.evaporation_rate = 0.0;
+  EXPECT_ANY_THROW(ant.SetOptions(options));
+  options = Ant::Options();
+  options.acs_q0 = 1.5;
+  EXPECT_ANY_THROW(ant.SetOptions(options));
+  options = Ant::Options();
+  options.acs_local_evaporation = 0.0;
+  EXPECT_NO_THROW(ant.SetOptions(options));
+  options.acs_local_evaporation = 1.5;
+  EXPECT_ANY_THROW(ant.SetOptions(options));
+  options = Ant::Options();
+  options.max_min_p_best = 1.0;
+  EXPECT_ANY_THROW(ant.SetOptions(options));
+  options = Ant::Options();
+  options.min_entropy = -0.5;
+  EXPECT_ANY_THROW(ant.SetOptions(options));
+  options = Ant::Options();
+  options.colonies = 0;
+  EXPECT_ANY_THROW(ant.SetOptions(options));
+}
+
 TEST_F(ANT, TSP_EMPTY_GRAPH) { EXPECT_ANY_THROW(ant.LoadGraph(graph)); }
 
 TEST_F(ANT, TSP_NON_COMPLETE_GRAPH) {
@@ -0,0 +1,58 @@
+#include "tests/test_core.h"
+
+namespace Test {
+
+TEST_F(BENCHMARK, JSON_ESCAPE) {
+  Benchmark benchmark(options);
+  benchmark.Run("quote\"backslash\\newline\n\x01", {{"tab\t", 1.0}}, 1.0,
+                "calls/s", [] { return 0; });
+  std::ostringstream json;
+  benchmark.WriteJson(json);
+
+  EXPECT_NE(json.str().find(
+                R"("name": "quote\"backslash\\newline\n\u0001")"),
+            std::string::npos);
+  EXPECT_NE(json.str().find(R"("parameters": {"tab\t": 1})"),
+            std::string::npos);
+  // Every control character left in the output is JSON whitespace.
+  for (char c : json.str()) {
+    EXPECT_TRUE(static_cast<unsigned char>(c) >= 0x20 || c == '\n');
+  }
+}
+
+TEST_F(BENCHMARK, STATISTICS) {
+  Benchmark benchmark(options);
+  unsigned calls = 0;
+  benchmark.Run("sleep", {}, 1.0, "calls/s", [&calls] {
+    std::this_thread::sleep_for(std::chrono::microseconds(50 * (++calls % 3)));
+    return calls;
+  });
+
+  ASSERT_EQ(benchmark.GetResults().size(), 1u);
+  const auto& result = benchmark.GetResults().front();
+  EXPECT_EQ(calls, options.warmup_iterations + options.max_iterations);
+  EXPECT_EQ(result.iterations, options.max_iterations);
+  EXPECT_LE(result.min_ns, result.median_ns);
+  EXPECT_LE(result.median_ns, result.p99_ns);
+  EXPECT_LE(result.min_ns, result.mean_ns);
+  EXPECT_LE(result.mean_ns, result.p99_ns);
+  EXPECT_DOUBLE_EQ(result.throughput, 1e9 / result.median_ns);
+}
+
+TEST_F(BENCHMARK, FILTER) {
+  options.filter = "Grape";
+  Benchmark benchmark(options);
+  unsigned calls = 0;
+  benchmark.Run("Gauss", {}, 1.0, "calls/s", [&calls] { return ++calls; });
+  EXPECT_TRUE(benchmark.GetResults().empty());
+  EXPECT_EQ(calls, 0u);
+
+  benchmark.Run("ClassicParallelGrape", {}, 1.0, "calls/s",
+                [&calls] { return ++calls; });
+  EXPECT_EQ(benchmark.GetResults().size(), 1u);
+
+  options.max_iterations = 0;
+  EXPECT_THROW(Benchmark{options}, std::invalid_argument);
+}
+
+}  // namespace Test
@@ -62,4 +62,12 @@ bool GRAPE::CompareMatrices(const Matrix<double>& m1,
   return true;
 }
 
+void THREAD_POOL::SpawnTree(ThreadPool& pool, unsigned depth) {
+  ++counter;
+  if (depth > 0) {
+    pool.AddTask([this, &pool, depth] { SpawnTree(pool, depth - 1); });
+    pool.AddTask([this, &pool, depth] { SpawnTree(pool, depth - 1); });
+  }
+}
+
 }  // namespace Test
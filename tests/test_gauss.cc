@@ -6,24 +6,175 @@ TEST_F(GAUSS, MATRIX_3X4) {
   matrix.LoadMatrixFromFile(File::kGaussMatrix3x4);
   GaussSplit(matrix, vector);
   gauss.LoadData(matrix, vector);
+  blocked_gauss.LoadData(matrix, vector);
   parallel_gauss.LoadData(matrix, vector);
-  EXPECT_TRUE(CompareVectors(gauss.Solve(), parallel_gauss.Solve()));
+  auto expected = gauss.Solve();
+  EXPECT_TRUE(CompareVectors(expected, blocked_gauss.Solve()));
+  EXPECT_TRUE(CompareVectors(expected, parallel_gauss.Solve()));
 }
 
 TEST_F(GAUSS, MATRIX_11X12) {
   matrix.LoadMatrixFromFile(File::kGaussMatrix11x12);
   GaussSplit(matrix, vector);
   gauss.LoadData(matrix, vector);
+  blocked_gauss.LoadData(matrix, vector);
   parallel_gauss.LoadData(matrix, vector);
-  EXPECT_TRUE(CompareVectors(gauss.Solve(), parallel_gauss.Solve()));
+  auto expected = gauss.Solve();
+  EXPECT_TRUE(CompareVectors(expected, blocked_gauss.Solve()));
+  EXPECT_TRUE(CompareVectors(expected, parallel_gauss.Solve()));
 }
 
 TEST_F(GAUSS, MATRIX_1000X1001) {
   matrix.LoadMatrixFromFile(File::kGaussMatrix1000x1001);
   GaussSplit(matrix, vector);
   gauss.LoadData(matrix, vector);
+  blocked_gauss.LoadData(matrix, vector);
   parallel_gauss.LoadData(matrix, vector);
-  EXPECT_TRUE(CompareVectors(gauss.Solve(), parallel_gauss.Solve()));
+  auto expected = gauss.Solve();
+  EXPECT_TRUE(CompareVectors(expected, blocked_gauss.Solve()));
+  EXPECT_TRUE(CompareVectors(expected, parallel_gauss.Solve()));
+}
+
+TEST_F(GAUSS, BLOCKED_GENERATED_SYSTEM) {
+  matrix.Generate(300, 300);
+  std::vector<double> x(300);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = double(i % 7) - 3;
+  }
+  vector.assign(300, 0);
+  for (std::size_t i = 0; i < 300; ++i) {
+    for (std::size_t j = 0; j < 300; ++j) {
+      vector[i] += matrix[i][j] * x[j];
+    }
+  }
+  blocked_gauss.LoadData(matrix, vector);
+  EXPECT_TRUE(CompareVectors(blocked_gauss.Solve(), x));
+}
+
+TEST_F(GAUSS, LU_SOLVE_MANY) {
+  matrix.Generate(150, 150);
+  ASSERT_TRUE(lu.Factorize(matrix));
+  Matrix<double> batch(150, 3);
+
+  for (std::size_t k = 0; k < 3; ++k) {
+    vector.assign(150, 0);
+    for (std::size_t i = 0; i < 150; ++i) {
+      vector[i] = double((i + k) % 11) - 5;
+      batch[i][k] = vector[i];
+    }
+    gauss.LoadData(matrix, vector);
+    std::vector<double> expected = gauss.Solve();
+    EXPECT_TRUE(CompareVectors(lu.Solve(vector), expected));
+
+    Matrix<double> solved = lu.Solve(batch);
+    std::vector<double> column(150);
+    for (std::size_t i = 0; i < 150; ++i) {
+      column[i] = solved[i][k];
+    }
+    EXPECT_TRUE(CompareVectors(column, expected));
+  }
+}
+
+TEST_F(GAUSS, LU_PARALLEL_SOLVE) {
+  ThreadPool pool(4);
+  matrix.Generate(600, 600);
+  std::vector<double> x(600);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = i % 3 == 0 ? 0 : double(i % 7) - 3;
+  }
+  vector.assign(600, 0);
+  for (std::size_t i = 0; i < 600; ++i) {
+    for (std::size_t j = 0; j < 600; ++j) {
+      vector[i] += matrix[i][j] * x[j];
+    }
+  }
+  ASSERT_TRUE(lu.Factorize(matrix, pool));
+  EXPECT_TRUE(CompareVectors(lu.Solve(vector, pool), x));
+  EXPECT_TRUE(CompareVectors(lu.Solve(vector, pool), lu.Solve(vector)));
+}
+
+TEST_F(GAUSS, LU_SINGULAR_MATRIX) {
+  matrix = Matrix<double>(2, 2, {3, 3, 5, 5});
+  EXPECT_FALSE(lu.Factorize(matrix));
+  EXPECT_FALSE(lu.IsFactorized());
+  EXPECT_ANY_THROW(lu.Solve(std::vector<double>{1, 2}));
+  EXPECT_ANY_THROW(LuFactorization{matrix});
+}
+
+TEST_F(GAUSS, LU_WRONG_SIZES) {
+  EXPECT_ANY_THROW(lu.Factorize(Matrix<double>(2, 3, 1.0)));
+  ASSERT_TRUE(lu.Factorize(Matrix<double>(2, 2, {2, 1, 1, 3})));
+  EXPECT_ANY_THROW(lu.Solve(std::vector<double>{1, 2, 3}));
+  EXPECT_ANY_THROW(lu.Solve(Matrix<double>(3, 1, 1.0)));
+}
+
+TEST_F(GAUSS, PARALLEL_GENERATED_SYSTEM) {
+  ThreadPool pool(4);
+  matrix.Generate(300, 300);
+  std::vector<double> x(300);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = double(i % 5) - 2;
+  }
+  vector.assign(300, 0);
+  for (std::size_t i = 0; i < 300; ++i) {
+    for (std::size_t j = 0; j < 300; ++j) {
+      vector[i] += matrix[i][j] * x[j];
+    }
+  }
+  parallel_gauss.LoadData(matrix, vector);
+  EXPECT_TRUE(CompareVectors(parallel_gauss.Solve(pool), x));
+}
+
+TEST_F(GAUSS, PARALLEL_SINGULAR_SYSTEM) {
+  ThreadPool pool(4);
+  matrix.Generate(150, 150);
+  for (std::size_t j = 0; j < 150; ++j) {
+    matrix[149][j] = matrix[100][j];
+  }
+  vector.assign(150, 1);
+  EXPECT_FALSE(lu.Factorize(matrix, pool));
+  parallel_gauss.LoadData(matrix, vector);
+  EXPECT_ANY_THROW(parallel_gauss.Solve(pool));
+}
+
+TEST_F(GAUSS, SOLVE_IN_POOL_TASK) {
+  ThreadPool pool(2);
+  matrix.Generate(200, 200);
+  std::vector<double> x(200);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = double(i % 5) - 2;
+  }
+  vector.assign(200, 0);
+  for (std::size_t i = 0; i < 200; ++i) {
+    for (std::size_t j = 0; j < 200; ++j) {
+      vector[i] += matrix[i][j] * x[j];
+    }
+  }
+
+  // More solves than workers, so the waiting ones have to help.
+  std::vector<std::future<std::vector<double>>> solutions;
+  for (unsigned i = 0; i < 4; ++i) {
+    solutions.push_back(pool.AddTask([this, &pool] {
+      ParallelGauss nested(matrix, vector);
+      return nested.Solve(pool);
+    }));
+  }
+  for (auto& solution : solutions) {
+    EXPECT_TRUE(CompareVectors(solution.get(), x));
+  }
+  parallel_gauss.LoadData(matrix, vector);
+  auto shared = ThreadPool::Shared().AddTask(
+      [this] { return parallel_gauss.Solve(); });
+  EXPECT_TRUE(CompareVectors(shared.get(), x));
+}
+
+TEST_F(GAUSS, SHARED_THREAD_POOL) {
+  ThreadPool pool(2);
+  matrix.LoadMatrixFromFile(File::kGaussMatrix11x12);
+  GaussSplit(matrix, vector);
+  gauss.LoadData(matrix, vector);
+  parallel_gauss.LoadData(matrix, vector);
+  EXPECT_TRUE(CompareVectors(gauss.Solve(), parallel_gauss.Solve(pool)));
 }
 
 TEST_F(GAUSS, ONE_SOLUTION) {
@@ -31,7 +182,9 @@ TEST_F(GAUSS, ONE_SOLUTION) {
   GaussSplit(matrix, vector);
   gauss.LoadData(matrix, vector);
   parallel_gauss.LoadData(matrix, vector);
+  blocked_gauss.LoadData(matrix, vector);
   EXPECT_TRUE(CompareVectors(gauss.Solve(), {10.485627, -0.519515}));
+  EXPECT_TRUE(CompareVectors(blocked_gauss.Solve(), {10.485627, -0.519515}));
   EXPECT_TRUE(CompareVectors(parallel_gauss.Solve(), {10.485627, -0.519515}));
 }
 
@@ -40,8 +193,10 @@ TEST_F(GAUSS, INFINITE_NUMBER_OF_SOLUTIONS) {
   GaussSplit(matrix, vector);
   gauss.LoadData(matrix, vector);
   parallel_gauss.LoadData(matrix, vector);
+  blocked_gauss.LoadData(matrix, vector);
   EXPECT_ANY_THROW(parallel_gauss.Solve());
   EXPECT_ANY_THROW(gauss.Solve());
+  EXPECT_ANY_THROW(blocked_gauss.Solve());
 }
 
 TEST_F(GAUSS, INFINITE_NUMBER_OF_SOLUTIONS2) {
@@ -49,8 +204,10 @@ TEST_F(GAUSS, INFINITE_NUMBER_OF_SOLUTIONS2) {
   GaussSplit(matrix, vector);
   gauss.LoadData(matrix, vector);
   parallel_gauss.LoadData(matrix, vector);
+  blocked_gauss.LoadData(matrix, vector);
   EXPECT_ANY_THROW(parallel_gauss.Solve());
   EXPECT_ANY_THROW(gauss.Solve());
+  EXPECT_ANY_THROW(blocked_gauss.Solve());
 }
 
 TEST_F(GAUSS, NO_SOLUTIONS) {
@@ -58,8 +215,10 @@ TEST_F(GAUSS, NO_SOLUTIONS) {
   GaussSplit(matrix, vector);
   gauss.LoadData(matrix, vector);
   parallel_gauss.LoadData(matrix, vector);
+  blocked_gauss.LoadData(matrix, vector);
   EXPECT_TRUE(parallel_gauss.Solve().empty());
   EXPECT_TRUE(gauss.Solve().empty());
+  EXPECT_TRUE(blocked_gauss.Solve().empty());
 }
 
 TEST_F(GAUSS, INCOMPLETE_MATRIX) {
@@ -67,11 +226,13 @@ TEST_F(GAUSS, INCOMPLETE_MATRIX) {
   GaussSplit(matrix, vector);
   vector.pop_back();
   EXPECT_ANY_THROW(gauss.LoadData(matrix, vector));
+  EXPECT_ANY_THROW(blocked_gauss.LoadData(matrix, vector));
   EXPECT_ANY_THROW(parallel_gauss.LoadData(matrix, vector));
 }
 
 TEST_F(GAUSS, EMPTY_MATRIX) {
   EXPECT_ANY_THROW(gauss.LoadData(matrix, vector));
+  EXPECT_ANY_THROW(blocked_gauss.LoadData(matrix, vector));
   EXPECT_ANY_THROW(parallel_gauss.LoadData(matrix, vector));
 }
 
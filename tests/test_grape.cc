@@ -9,12 +9,8 @@ TEST_F(GRAPE, GENERATED_SQUARE_MATRICES) {
     grape.LoadMatrices(m1, m2);
     classic_parallel_grape.LoadMatrices(m1, m2);
     pipeline_parallel_grape.LoadMatrices(m1, m2);
-    EXPECT_TRUE(CompareMatrices(
-        grape.Mul(),
-        ConvertAtomicMatrixToDouble(classic_parallel_grape.Mul(6))));
-    EXPECT_TRUE(CompareMatrices(
-        grape.Mul(),
-        ConvertAtomicMatrixToDouble(pipeline_parallel_grape.Mul(6))));
+    EXPECT_TRUE(CompareMatrices(grape.Mul(), classic_parallel_grape.Mul(6)));
+    EXPECT_TRUE(CompareMatrices(grape.Mul(), pipeline_parallel_grape.Mul(6)));
   }
 
   for (unsigned i = 0; i < 10; ++i) {
@@ -23,12 +19,8 @@ TEST_F(GRAPE, GENERATED_SQUARE_MATRICES) {
     grape.LoadMatrices(m1, m2);
     classic_parallel_grape.LoadMatrices(m1, m2);
     pipeline_parallel_grape.LoadMatrices(m1, m2);
-    EXPECT_TRUE(CompareMatrices(
-        grape.Mul(),
-        ConvertAtomicMatrixToDouble(classic_parallel_grape.Mul(6))));
-    EXPECT_TRUE(CompareMatrices(
-        grape.Mul(),
-        ConvertAtomicMatrixToDouble(pipeline_parallel_grape.Mul(6))));
+    EXPECT_TRUE(CompareMatrices(grape.Mul(), classic_parallel_grape.Mul(6)));
+    EXPECT_TRUE(CompareMatrices(grape.Mul(), pipeline_parallel_grape.Mul(6)));
   }
 
   //    for (unsigned i = 0; i < 10; ++i)
@@ -39,9 +31,9 @@ TEST_F(GRAPE, GENERATED_SQUARE_MATRICES) {
   //        classic_parallel_grape.LoadMatrices(m1, m2);
   //        pipeline_parallel_grape.LoadMatrices(m1, m2);
   //        EXPECT_TRUE(CompareMatrices(grape.Mul(),
-  //        ConvertAtomicMatrixToDouble(classic_parallel_grape.Mul(6))));
+  //        classic_parallel_grape.Mul(6)));
   //        EXPECT_TRUE(CompareMatrices(grape.Mul(),
-  //        ConvertAtomicMatrixToDouble(pipeline_parallel_grape.Mul(6))));
+  //        pipeline_parallel_grape.Mul(6)));
   //    }
 }
 
@@ -51,33 +43,79 @@ TEST_F(GRAPE, RECTANGULAR_MATRICES) {
   grape.LoadMatrices(m1, m2);
   classic_parallel_grape.LoadMatrices(m1, m2);
   pipeline_parallel_grape.LoadMatrices(m1, m2);
-  EXPECT_TRUE(CompareMatrices(
-      grape.Mul(), ConvertAtomicMatrixToDouble(classic_parallel_grape.Mul(6))));
-  EXPECT_TRUE(CompareMatrices(
-      grape.Mul(),
-      ConvertAtomicMatrixToDouble(pipeline_parallel_grape.Mul(6))));
+  EXPECT_TRUE(CompareMatrices(grape.Mul(), classic_parallel_grape.Mul(6)));
+  EXPECT_TRUE(CompareMatrices(grape.Mul(), pipeline_parallel_grape.Mul(6)));
 
   m1.Generate(3, 2);
   m2.Generate(2, 3);
   grape.LoadMatrices(m1, m2);
   classic_parallel_grape.LoadMatrices(m1, m2);
   pipeline_parallel_grape.LoadMatrices(m1, m2);
-  EXPECT_TRUE(CompareMatrices(
-      grape.Mul(), ConvertAtomicMatrixToDouble(classic_parallel_grape.Mul(6))));
-  EXPECT_TRUE(CompareMatrices(
-      grape.Mul(),
-      ConvertAtomicMatrixToDouble(pipeline_parallel_grape.Mul(6))));
+  EXPECT_TRUE(CompareMatrices(grape.Mul(), classic_parallel_grape.Mul(6)));
+  EXPECT_TRUE(CompareMatrices(grape.Mul(), pipeline_parallel_grape.Mul(6)));
 
   m1.Generate(3, 5);
   m2.Generate(5, 10);
   grape.LoadMatrices(m1, m2);
   classic_parallel_grape.LoadMatrices(m1, m2);
   pipeline_parallel_grape.LoadMatrices(m1, m2);
-  EXPECT_TRUE(CompareMatrices(
-      grape.Mul(), ConvertAtomicMatrixToDouble(classic_parallel_grape.Mul(6))));
-  EXPECT_TRUE(CompareMatrices(
-      grape.Mul(),
-      ConvertAtomicMatrixToDouble(pipeline_parallel_grape.Mul(6))));
+  EXPECT_TRUE(CompareMatrices(grape.Mul(), classic_parallel_grape.Mul(6)));
+  EXPECT_TRUE(CompareMatrices(grape.Mul(), pipeline_parallel_grape.Mul(6)));
+}
+
+TEST_F(GRAPE, BLOCKED_KERNEL_EDGES) {
+  m1.Generate(131, 301);
+  m2.Generate(301, 67);
+  grape.LoadMatrices(m1, m2);
+  classic_parallel_grape.LoadMatrices(m1, m2);
+  pipeline_parallel_grape.LoadMatrices(m1, m2);
+  EXPECT_TRUE(CompareMatrices(grape.Mul(), pipeline_parallel_grape.Mul(6)));
+  EXPECT_TRUE(CompareMatrices(classic_parallel_grape.Mul(6),
+                              pipeline_parallel_grape.Mul(6)));
+}
+
+TEST_F(GRAPE, SHARED_THREAD_POOL) {
+  ThreadPool pool(3);
+  for (unsigned i = 0; i < 3; ++i) {
+    m1.Generate(40, 30);
+    m2.Generate(30, 20);
+    grape.LoadMatrices(m1, m2);
+    classic_parallel_grape.LoadMatrices(m1, m2);
+    pipeline_parallel_grape.LoadMatrices(m1, m2);
+    EXPECT_TRUE(CompareMatrices(grape.Mul(), classic_parallel_grape.Mul(pool)));
+    EXPECT_TRUE(CompareMatrices(grape.Mul(), pipeline_parallel_grape.Mul()));
+  }
+
+  // Pinned workers compute the rows they first touched.
+  ThreadPool pinned(3, {ThreadPool::Affinity::kCompact, {}});
+  m1.Generate(131, 30);
+  classic_parallel_grape.LoadMatrices(m1, m2);
+  grape.LoadMatrices(m1, m2);
+  EXPECT_TRUE(CompareMatrices(grape.Mul(), classic_parallel_grape.Mul(pinned)));
+}
+
+TEST_F(GRAPE, MAPPED_MATRICES) {
+  auto directory = std::filesystem::temp_directory_path();
+  auto first = (directory / "s21_grape_m1.bin").string();
+  auto second = (directory / "s21_grape_m2.bin").string();
+  m1.Generate(37, 21);
+  m2.Generate(21, 15);
+  m1.SaveMatrixToBinaryFile(first);
+  m2.SaveMatrixToBinaryFile(second);
+  auto v1 = MatrixView<double>::Load(first);
+  auto v2 = MatrixView<double>::Load(second);
+  std::filesystem::remove(first);
+  std::filesystem::remove(second);
+
+  grape.LoadMatrices(m1, m2);
+  auto expected = grape.Mul();
+  grape.LoadMatrices(v1, v2);
+  classic_parallel_grape.LoadMatrices(v1, v2);
+  pipeline_parallel_grape.LoadMatrices(v1, v2);
+  EXPECT_TRUE(CompareMatrices(expected, grape.Mul()));
+  EXPECT_TRUE(CompareMatrices(expected, classic_parallel_grape.Mul(3)));
+  EXPECT_TRUE(CompareMatrices(expected, pipeline_parallel_grape.Mul(3)));
+  EXPECT_THROW(grape.LoadMatrices(v2, v1), std::invalid_argument);
 }
 
 TEST_F(GRAPE, EVEN_MANUAL_MATRICES) {
@@ -107,10 +145,8 @@ TEST_F(GRAPE, EVEN_MANUAL_MATRICES) {
   classic_parallel_grape.LoadMatrices(m1, m2);
   pipeline_parallel_grape.LoadMatrices(m1, m2);
   EXPECT_TRUE(CompareMatrices(grape.Mul(), result));
-  EXPECT_TRUE(CompareMatrices(
-      ConvertAtomicMatrixToDouble(classic_parallel_grape.Mul(6)), result));
-  EXPECT_TRUE(CompareMatrices(
-      ConvertAtomicMatrixToDouble(pipeline_parallel_grape.Mul(6)), result));
+  EXPECT_TRUE(CompareMatrices(classic_parallel_grape.Mul(6), result));
+  EXPECT_TRUE(CompareMatrices(pipeline_parallel_grape.Mul(6), result));
 }
 
 TEST_F(GRAPE, UNEVEN_MANUAL_MATRICES) {
@@ -126,10 +162,8 @@ TEST_F(GRAPE, UNEVEN_MANUAL_MATRICES) {
   classic_parallel_grape.LoadMatrices(m1, m2);
   pipeline_parallel_grape.LoadMatrices(m1, m2);
   EXPECT_TRUE(CompareMatrices(grape.Mul(), result));
-  EXPECT_TRUE(CompareMatrices(
-      ConvertAtomicMatrixToDouble(classic_parallel_grape.Mul(6)), result));
-  EXPECT_TRUE(CompareMatrices(
-      ConvertAtomicMatrixToDouble(pipeline_parallel_grape.Mul(6)), result));
+  EXPECT_TRUE(CompareMatrices(classic_parallel_grape.Mul(6), result));
+  EXPECT_TRUE(CompareMatrices(pipeline_parallel_grape.Mul(6), result));
 }
 
 TEST_F(GRAPE, INCORRECT_MATRIX_SIZE) {
@@ -150,4 +184,65 @@ TEST_F(GRAPE, INCORRECT_MATRIX_SIZE) {
   EXPECT_ANY_THROW(pipeline_parallel_grape.LoadMatrices(m1, m2));
 }
 
+TEST_F(GRAPE, PERF_PHASES) {
+  if (!PerfCounters::Enable()) {
+    GTEST_SKIP() << "perf_event_open is not available";
+  }
+  PerfCounters::Reset();
+  m1.Generate(40, 30);
+  m2.Generate(30, 20);
+  pipeline_parallel_grape.LoadMatrices(m1, m2);
+  ThreadPool pool(2);
+  pipeline_parallel_grape.Mul(pool);
+
+  std::uint64_t product_calls = 0;
+  std::uint64_t factor_calls = 0;
+  for (const auto& sample : PerfCounters::GetSamples()) {
+    if (sample.phase == "grape/product") {
+      product_calls += sample.calls;
+      EXPECT_GT(sample.values[PerfCounters::kTaskClock], 0);
+    } else if (sample.phase == "grape/factors") {
+      factor_calls += sample.calls;
+    }
+  }
+  EXPECT_EQ(product_calls, 40);
+  EXPECT_EQ(factor_calls, 60);
+
+  // Samples belong to the threads that ran the phases, and the time spent in
+  // the nested phase is not counted in the outer one.
+  PerfCounters::Reset();
+  std::mutex threads_mtx;
+  std::set<std::thread::id> threads;
+  pool.ParallelFor(0, 8, 1, [&threads_mtx, &threads](std::size_t first,
+                                                     std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      PerfPhase product("grape/product");
+      {
+        std::lock_guard<std::mutex> lock(threads_mtx);
+        threads.insert(std::this_thread::get_id());
+      }
+      PerfPhase factors("grape/factors");
+      auto until = std::chrono::steady_clock::now() +
+                   std::chrono::milliseconds(2);
+      while (std::chrono::steady_clock::now() < until) {
+      }
+    }
+  });
+  PerfCounters::Disable();
+
+  std::uint64_t product_clock = 0;
+  std::uint64_t factor_clock = 0;
+  for (const auto& sample : PerfCounters::GetSamples()) {
+    // Threads are numbered from 0 in the order they entered a phase.
+    EXPECT_LT(sample.thread, threads.size());
+    if (sample.phase == "grape/product") {
+      product_clock += sample.values[PerfCounters::kTaskClock];
+    } else if (sample.phase == "grape/factors") {
+      factor_clock += sample.values[PerfCounters::kTaskClock];
+    }
+  }
+  EXPECT_GT(factor_clock, 0);
+  EXPECT_LT(product_clock, factor_clock / 2);
+}
+
 }  // namespace Test
@@ -0,0 +1,155 @@
+#include "tests/test_core.h"
+
+namespace Test {
+
+TEST_F(MATRIX, PARSE) {
+  matrix.Parse("2 3\n1 -2.5 +3\n\n4e2\t5 6 \r\n");
+  ASSERT_EQ(matrix.GetRows(), 2u);
+  ASSERT_EQ(matrix.GetCols(), 3u);
+  EXPECT_EQ(matrix(0, 1), -2.5);
+  EXPECT_EQ(matrix(0, 2), 3.0);
+  EXPECT_EQ(matrix(1, 0), 400.0);
+  EXPECT_EQ(matrix(1, 2), 6.0);
+
+  EXPECT_THROW(matrix.Parse("2 2\n1 2 3\n4 5\n"), std::invalid_argument);
+  EXPECT_THROW(matrix.Parse("2 2\n1 2\n4\n"), std::invalid_argument);
+  EXPECT_THROW(matrix.Parse("2 2\n1 2\n4 x\n"), std::invalid_argument);
+  EXPECT_THROW(matrix.Parse("2 2\n1 +-2\n3 4\n"), std::invalid_argument);
+  EXPECT_THROW(matrix.Parse("2 2\n1 + 2\n3 4\n"), std::invalid_argument);
+  EXPECT_THROW(matrix.Parse("2 2\n1 2\n"), std::invalid_argument);
+  EXPECT_THROW(matrix.Parse("two 2\n"), std::invalid_argument);
+  EXPECT_THROW(matrix.Parse("100000000 100000000\n1 2\n"),
+               std::invalid_argument);
+  EXPECT_THROW(matrix.Parse("4294967296 4294967296\n"),
+               std::invalid_argument);
+  EXPECT_THROW(matrix.LoadMatrixFromFile("./tests/materials/missing.txt"),
+               std::runtime_error);
+
+  ThreadPool pool(4);
+  Matrix<double> generated;
+  generated.Generate(600, 600);
+  std::ostringstream text;
+  generated.PrintFull(text);
+  matrix.Parse(text.str(), pool);
+  Matrix<double> expected;
+  expected.Parse(text.str());
+  EXPECT_EQ(matrix.GetRows(), 600u);
+  EXPECT_TRUE(matrix == expected);
+  std::string broken = text.str();
+  broken.insert(broken.find('\n', broken.size() / 2) + 1, "1 x\n");
+  EXPECT_THROW(matrix.Parse(broken, pool), std::invalid_argument);
+  EXPECT_THROW(matrix.Parse(text.str().substr(0, text.str().size() / 2), pool),
+               std::invalid_argument);
+  std::string long_row = text.str();
+  long_row.insert(long_row.rfind('\n'), " 7");
+  EXPECT_THROW(expected.Parse(long_row), std::invalid_argument);
+  EXPECT_THROW(matrix.Parse(long_row, pool), std::invalid_argument);
+  std::string trailing = text.str() + "1 x\n";
+  expected.Parse(trailing);
+  matrix.Parse(trailing, pool);
+  EXPECT_TRUE(matrix == expected);
+}
+
+TEST_F(MATRIX, BINARY) {
+  auto filename =
+      (std::filesystem::temp_directory_path() / "s21_binary_matrix.bin")
+          .string();
+  matrix.Generate(40, 41);
+  matrix.SaveMatrixToBinaryFile(filename);
+
+  Matrix<double> loaded;
+  loaded.LoadMatrixFromFile(filename);
+  EXPECT_TRUE(loaded == matrix);
+  auto view = MatrixView<double>::Map(filename);
+  ASSERT_EQ(view.GetRows(), 40u);
+  ASSERT_EQ(view.GetCols(), 41u);
+  EXPECT_EQ(view(39, 40), matrix(39, 40));
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(view.GetData()) %
+                BinaryHeader::kAlignment,
+            0u);
+  EXPECT_TRUE(view.ToMatrix() == matrix);
+  auto loaded_view = MatrixView<double>::Load(filename);
+  EXPECT_EQ(loaded_view(39, 40), matrix(39, 40));
+  EXPECT_EQ(loaded_view[39][40], matrix(39, 40));
+  auto text_view = MatrixView<double>::Load(File::kGaussMatrix3x4);
+  Matrix<double> text;
+  text.LoadMatrixFromFile(File::kGaussMatrix3x4);
+  EXPECT_TRUE(text_view.ToMatrix() == text);
+  EXPECT_THROW(MatrixView<float>::Map(filename), std::invalid_argument);
+  EXPECT_THROW(MatrixView<double>::Map(File::kGaussMatrix3x4),
+               std::invalid_argument);
+
+  std::filesystem::resize_file(filename, 1000);
+  EXPECT_THROW(loaded.LoadMatrixFromFile(filename), std::invalid_argument);
+
+  // rows x cols wraps around to 0 values.
+  WriteBinaryFile(filename, DataType::kFloat64, BinaryLayout::kMatrix,
+                  std::uint64_t(1) << 62, 4, nullptr, 0);
+  EXPECT_THROW(loaded.LoadMatrixFromFile(filename), std::invalid_argument);
+  EXPECT_THROW(MatrixView<double>::Map(filename), std::invalid_argument);
+  // A misaligned double.
+  double value = 1.0;
+  WriteBinaryFile(filename, DataType::kFloat64, BinaryLayout::kMatrix, 1, 1,
+                  &value, sizeof(value));
+  std::filesystem::resize_file(filename, 128);
+  {
+    std::fstream file(filename, std::ios::binary | std::ios::in |
+                                    std::ios::out);
+    BinaryHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    header.alignment = 1;
+    header.data_offset = 65;
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+  EXPECT_THROW(loaded.LoadMatrixFromFile(filename), std::invalid_argument);
+  EXPECT_THROW(MatrixView<double>::Map(filename), std::invalid_argument);
+  std::filesystem::remove(filename);
+}
+
+TEST_F(MATRIX, WITHOUT_DATA_TYPE) {
+  auto filename =
+      (std::filesystem::temp_directory_path() / "s21_int_matrix.bin").string();
+  Matrix<int> loaded;
+  loaded.LoadMatrixFromFile(File::kGaussMatrix3x4);
+  ASSERT_EQ(loaded.GetRows(), 3u);
+  ASSERT_EQ(loaded.GetCols(), 4u);
+  EXPECT_EQ(loaded(2, 3), 17);
+
+  matrix.Generate(2, 2);
+  matrix.SaveMatrixToBinaryFile(filename);
+  EXPECT_THROW(loaded.LoadMatrixFromFile(filename), std::invalid_argument);
+  std::filesystem::remove(filename);
+}
+
+TEST_F(MATRIX, FIRST_TOUCH) {
+  ThreadPool pool(3);
+  EXPECT_EQ(Matrix<double>(100, 7, pool), Matrix<double>(100, 7));
+  matrix.Generate(100, 7);
+  EXPECT_EQ(Matrix<double>(matrix, pool), matrix);
+  EXPECT_EQ(Matrix<double>(0, 0, pool).GetRows(), 0u);
+
+  // Every row is first touched, and later written through ForEachRowBlock(),
+  // by the same worker.
+  Touch::pool = &pool;
+  Matrix<Touch> touched(100, 7, pool);
+  Touch::pool = nullptr;
+  std::vector<int> written(touched.GetRows(), -2);
+  touched.ForEachRowBlock(
+      pool, [&pool, &written](std::size_t first, std::size_t last) {
+        // The first block is slow, so idle workers would steal the others.
+        if (first == 0) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        std::fill(written.begin() + first, written.begin() + last,
+                  pool.GetCurrentWorker());
+      });
+  for (std::size_t row = 0; row < written.size(); ++row) {
+    EXPECT_GE(written[row], 0);
+    for (std::size_t col = 0; col < 7; ++col) {
+      EXPECT_EQ(touched(row, col).worker, written[row]);
+    }
+  }
+}
+
+}  // namespace Test
@@ -0,0 +1,279 @@
+#include "tests/test_core.h"
+
+namespace Test {
+
+TEST_F(THREAD_POOL, ALL_TASKS_ARE_EXECUTED) {
+  ThreadPool pool(kThreads);
+  for (unsigned i = 0; i < 10000; ++i) {
+    pool.AddTask([this] { ++counter; });
+  }
+  pool.Join();
+  EXPECT_EQ(counter, 10000u);
+}
+
+TEST_F(THREAD_POOL, NESTED_TASKS) {
+  ThreadPool pool(kThreads);
+  pool.AddTask([this, &pool] { SpawnTree(pool, 12); });
+  pool.Join();
+  EXPECT_EQ(counter, (1u << 13) - 1);
+}
+
+TEST_F(THREAD_POOL, FUTURES) {
+  ThreadPool pool(kThreads);
+  std::vector<std::future<unsigned>> results;
+  for (unsigned i = 0; i < 100; ++i) {
+    results.push_back(pool.AddTask([](unsigned x) { return x * x; }, i));
+  }
+  for (unsigned i = 0; i < 100; ++i) {
+    EXPECT_EQ(results[i].get(), i * i);
+  }
+  auto failed = pool.AddTask([] { throw std::runtime_error("task failed"); });
+  EXPECT_THROW(failed.get(), std::runtime_error);
+}
+
+TEST_F(THREAD_POOL, WORK_STEALING_DEQUE) {
+  WorkStealingDeque<int*> deque(2);
+  std::vector<int> values(1000);
+  for (auto& value : values) {
+    deque.Push(&value);
+  }
+  int* item = nullptr;
+  EXPECT_TRUE(deque.Steal(item));
+  EXPECT_EQ(item, &values.front());
+  EXPECT_TRUE(deque.Pop(item));
+  EXPECT_EQ(item, &values.back());
+  while (deque.Pop(item)) {
+  }
+  EXPECT_TRUE(deque.Empty());
+  EXPECT_FALSE(deque.Steal(item));
+}
+
+TEST_F(THREAD_POOL, TASK_GRAPH_ORDER) {
+  ThreadPool pool(kThreads);
+  TaskGraph graph;
+  std::vector<unsigned> finished(64);
+  std::vector<TaskGraph::Node> nodes;
+
+  // Task i depends on tasks i / 2 and i - 1, so it must see both finished.
+  for (unsigned i = 0; i < finished.size(); ++i) {
+    nodes.push_back(graph.AddTask([this, &finished, i] {
+      bool ready = i == 0 || (finished[i / 2] && finished[i - 1]);
+      finished[i] = ready ? ++counter : 0;
+    }));
+    if (i > 0) {
+      graph.AddDependency(nodes[i / 2], nodes[i]);
+      graph.AddDependency(nodes[i - 1], nodes[i]);
+    }
+  }
+  graph.Run(pool);
+  EXPECT_EQ(counter, 64u);
+  EXPECT_EQ(finished.back(), 64u);
+  EXPECT_ANY_THROW(graph.AddDependency(nodes[5], nodes[2]));
+}
+
+TEST_F(THREAD_POOL, TASK_GRAPH_EXCEPTION) {
+  ThreadPool pool(kThreads);
+  TaskGraph graph;
+  auto first = graph.AddTask([] { throw std::runtime_error("task failed"); });
+  auto second = graph.AddTask([this] { ++counter; });
+  graph.AddDependency(first, second);
+  EXPECT_THROW(graph.Run(pool), std::runtime_error);
+  EXPECT_EQ(counter, 0u);
+  EXPECT_EQ(pool.GetCurrentWorker(), -1);
+}
+
+TEST_F(THREAD_POOL, STATS) {
+  ThreadPool pool(kThreads);
+  if (!ThreadPool::kStatsEnabled) {
+    EXPECT_FALSE(pool.GetStats().enabled);
+    GTEST_SKIP() << "built without S21_THREAD_POOL_STATS";
+  }
+  pool.SetTracing(true);
+  for (unsigned i = 0; i < 1000; ++i) {
+    pool.AddTask([this] { ++counter; });
+  }
+  pool.Join();
+
+  auto stats = pool.GetStats();
+  ASSERT_EQ(stats.workers.size(), kThreads);
+  std::uint64_t tasks = 0;
+  for (const auto& worker : stats.workers) {
+    tasks += worker.tasks;
+  }
+  EXPECT_EQ(tasks, 1000u);
+  EXPECT_EQ(std::accumulate(stats.run_time_histogram.begin(),
+                            stats.run_time_histogram.end(), 0ull),
+            1000u);
+  EXPECT_EQ(std::accumulate(stats.latency_histogram.begin(),
+                            stats.latency_histogram.end(), 0ull),
+            1000u);
+  EXPECT_GE(stats.lock_acquisitions, stats.lock_contentions);
+
+  std::ostringstream trace;
+  pool.WriteTrace(trace);
+  EXPECT_NE(trace.str().find("\"traceEvents\""), std::string::npos);
+  EXPECT_NE(trace.str().find("\"name\": \"task\""), std::string::npos);
+
+  pool.ResetStats();
+  EXPECT_EQ(pool.GetStats().workers[0].tasks, 0u);
+}
+
+TEST_F(THREAD_POOL, PARALLEL_FOR) {
+  ThreadPool pool(kThreads);
+  for (auto schedule :
+       {ThreadPool::Schedule::kStatic, ThreadPool::Schedule::kDynamic,
+        ThreadPool::Schedule::kGuided}) {
+    std::vector<std::atomic<unsigned>> visits(1000);
+    pool.ParallelFor(
+        10, 1000, 7,
+        [&visits](std::size_t first, std::size_t last) {
+          EXPECT_LT(first, last);
+          for (std::size_t i = first; i < last; ++i) {
+            ++visits[i];
+          }
+        },
+        schedule);
+    for (std::size_t i = 0; i < visits.size(); ++i) {
+      EXPECT_EQ(visits[i], i < 10 ? 0u : 1u);
+    }
+  }
+
+  // Nested loops run on the workers that wait for them.
+  pool.ParallelFor(0, kThreads, 1, [this, &pool](std::size_t, std::size_t) {
+    pool.ParallelFor(0, 100, 1, [this](std::size_t first, std::size_t last) {
+      counter += unsigned(last - first);
+    });
+  });
+  EXPECT_EQ(counter, 100 * kThreads);
+
+  EXPECT_THROW(pool.ParallelFor(0, 100, 1,
+                                [](std::size_t first, std::size_t) {
+                                  if (first > 0) {
+                                    throw std::runtime_error("chunk failed");
+                                  }
+                                },
+                                ThreadPool::Schedule::kDynamic),
+               std::runtime_error);
+
+  // A static part not yet started when another one throws is skipped too.
+  std::promise<void> gate;
+  std::shared_future<void> open = gate.get_future().share();
+  std::atomic<unsigned> blocked{};
+  pool.AddTasks(kThreads, [&open, &blocked](std::size_t) {
+    ++blocked;
+    open.wait();
+  });
+  while (blocked < kThreads) {
+    std::this_thread::yield();
+  }
+  std::thread opener([&gate] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    gate.set_value();
+  });
+  counter = 0;
+  EXPECT_THROW(pool.ParallelFor(0, kThreads, 1,
+                                [this](std::size_t first, std::size_t) {
+                                  if (first == 0) {
+                                    throw std::runtime_error("part failed");
+                                  }
+                                  ++counter;
+                                }),
+               std::runtime_error);
+  opener.join();
+  pool.Join();
+  EXPECT_EQ(counter, 0u);
+}
+
+TEST_F(THREAD_POOL, ADD_TASKS) {
+  ThreadPool pool(kThreads);
+  std::vector<unsigned> values(1000);
+  pool.AddTasks(values.size(), [&values](std::size_t i) {
+    values[i] = unsigned(i);
+  });
+  pool.AddTasks(0, [](std::size_t) {});
+  pool.Join();
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i], i);
+  }
+}
+
+TEST_F(THREAD_POOL, PARALLEL_FOR_STATIC_PARTS) {
+  ThreadPool pool(kThreads);
+  std::vector<int> ran_on(kThreads * 4, -2);
+  auto record = [&pool, &ran_on](std::size_t first, std::size_t last) {
+    // Part 0 is slow, so idle workers would steal the others' parts.
+    if (first == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    for (std::size_t i = first; i < last; ++i) {
+      ran_on[i] = pool.GetCurrentWorker();
+    }
+  };
+
+  pool.ParallelFor(0, ran_on.size(), 1, record,
+                   ThreadPool::Schedule::kStaticPinned);
+  for (std::size_t i = 0; i < ran_on.size(); ++i) {
+    EXPECT_EQ(ran_on[i], int(i / 4));
+  }
+  int single = -2;
+  pool.ParallelFor(
+      0, 1, 1,
+      [&pool, &single](std::size_t, std::size_t) {
+        single = pool.GetCurrentWorker();
+      },
+      ThreadPool::Schedule::kStaticPinned);
+  EXPECT_EQ(single, 0);
+
+  // A plain static loop, and a pinned one nested in a task, run part 0 on
+  // the calling thread.
+  pool.ParallelFor(0, ran_on.size(), 1, record);
+  EXPECT_EQ(ran_on[0], -1);
+  int caller = pool.AddTask([&pool, &ran_on, &record] {
+                     pool.ParallelFor(0, ran_on.size(), 1, record,
+                                      ThreadPool::Schedule::kStaticPinned);
+                     return pool.GetCurrentWorker();
+                   })
+                   .get();
+  EXPECT_EQ(ran_on[0], caller);
+}
+
+TEST_F(THREAD_POOL, AFFINITY) {
+  EXPECT_EQ(ThreadPool(kThreads).GetWorkerCpu(0), -1);
+
+  for (auto affinity :
+       {ThreadPool::Affinity::kCompact, ThreadPool::Affinity::kScatter}) {
+    ThreadPool pool(kThreads, {affinity, {}});
+    std::set<int> cpus;
+    for (std::size_t i = 0; i < kThreads; ++i) {
+      EXPECT_GE(pool.GetWorkerCpu(i), 0);
+      cpus.insert(pool.GetWorkerCpu(i));
+    }
+    // The calling thread takes part in the loop but is not pinned.
+    std::vector<int> ran_on(100, -1);
+    auto caller = std::this_thread::get_id();
+    pool.ParallelFor(
+        0, ran_on.size(), 1,
+        [&ran_on, caller](std::size_t first, std::size_t last) {
+          for (std::size_t i = first; i < last; ++i) {
+            if (std::this_thread::get_id() != caller) {
+              ran_on[i] = sched_getcpu();
+            }
+          }
+        },
+        ThreadPool::Schedule::kDynamic);
+    for (int cpu : ran_on) {
+      EXPECT_TRUE(cpu == -1 || cpus.count(cpu));
+    }
+  }
+
+  int cpu = ThreadPool(1, {ThreadPool::Affinity::kCompact, {}}).GetWorkerCpu(0);
+  ThreadPool pinned(2, {ThreadPool::Affinity::kExplicit, {unsigned(cpu)}});
+  EXPECT_EQ(pinned.GetWorkerCpu(1), cpu);
+  EXPECT_ANY_THROW(ThreadPool(2, {ThreadPool::Affinity::kExplicit, {}}));
+  EXPECT_ANY_THROW(
+      ThreadPool(2, {ThreadPool::Affinity::kExplicit, {1u << 20}}));
+}
+
+TEST_F(THREAD_POOL, ZERO_THREADS) { EXPECT_ANY_THROW(ThreadPool pool(0)); }
+
+}  // namespace Test